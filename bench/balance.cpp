@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../src/boids.hpp"
+
+// a collapsed flock: most boids packed into a few tight clusters, the rest spread over the window
+std::vector<Boid> collapsed_flock(int count, BoundingBox *bounds) {
+    srand(1);
+    std::vector<Boid> boids;
+    Vec2 centers[3] = {
+        Vec2::build(bounds->xmax * 0.3, bounds->ymax * 0.4),
+        Vec2::build(bounds->xmax * 0.6, bounds->ymax * 0.7),
+        Vec2::build(bounds->xmax * 0.8, bounds->ymax * 0.3),
+    };
+    for (int i = 0; i < count; i += 1) {
+        float angle = (float)rand() / RAND_MAX * TAU;
+        Vec2 velocity = Vec2::build(cos(angle), sin(angle)).mul(100);
+        Vec2 position = Vec2::build((float)rand() / RAND_MAX * bounds->xmax, (float)rand() / RAND_MAX * bounds->ymax);
+        if (i % 10 != 0) {
+            float radius = (float)rand() / RAND_MAX * 60;
+            position = centers[i % 3].add(Vec2::build(cos(angle), sin(angle)).mul(radius));
+        }
+        boids.push_back(Boid::build(position, velocity));
+    }
+    return boids;
+}
+
+void report(const char *name, BoidManager *manager, double ms) {
+    printf("%s: %.2f ms, pair imbalance %.2f\n", name, ms, manager->scheduler.imbalance());
+    printf("  %6s %14s %8s %8s %12s\n", "worker", "pairs", "items", "steals", "utilization");
+    for (int worker = 0; worker < (int)manager->scheduler.counters.size(); worker += 1) {
+        WorkerCounters &counters = manager->scheduler.counters[worker];
+        printf("  %6d %14lld %8d %8d %11.1f%%\n", worker, counters.pairs, counters.items, counters.steals,
+               counters.utilization() * 100);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 20000;
+    int threads = argc > 2 ? atoi(argv[2]) : std::thread::hardware_concurrency();
+
+    BoundingBox bounds = BoundingBox{.xmin = 0, .xmax = 1920, .ymin = 0, .ymax = 1080};
+    BoidManager manager = BoidManager{};
+    manager.params = BoidParams{
+        .neighbor_distance = 100,
+        .separation_distance = 50,
+        .cohesion = 0.625,
+        .alignment = 2.5,
+        .separation = 1000,
+        .peripheral_angle = PI / 6,
+    };
+    manager.boids = collapsed_flock(count, &bounds);
+    manager.populate_map(&bounds);
+
+    printf("%d boids, %d workers\n", count, threads);
+    Schedule schedules[2] = {SCHEDULE_STATIC, SCHEDULE_TILES};
+    const char *names[2] = {"static split", "tile stealing"};
+    for (int i = 0; i < 2; i += 1) {
+        manager.engine = EngineParams{.kernel = KERNEL_SIMD, .threads = threads, .schedule = schedules[i]};
+        manager.accumulate_forces(&bounds);
+
+        auto start = std::chrono::steady_clock::now();
+        manager.accumulate_forces(&bounds);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        report(names[i], &manager, ms);
+    }
+
+    return 0;
+}
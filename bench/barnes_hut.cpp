@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "scenarios.hpp"
+
+typedef struct Run {
+    double ms;
+    std::vector<Vec2> forces;
+} Run;
+
+// median wall time of accumulate_forces on one fixed state, and the forces it leaves
+Run run_forces(BoidManager *manager, BoundingBox *bounds, int repeats) {
+    std::vector<double> samples;
+    manager->populate_map(bounds);
+    for (int repeat = 0; repeat < repeats; repeat += 1) {
+        std::fill(manager->accelerations.begin(), manager->accelerations.end(), Vec2::zeros());
+        auto start = std::chrono::steady_clock::now();
+        manager->accumulate_forces(bounds);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    return Run{.ms = samples[samples.size() / 2], .forces = manager->accelerations};
+}
+
+// error against the exact tree, in units of the mean exact force so that boids with almost no force do not dominate
+void report(float opening, const Run *run, const Run *exact) {
+    double scale = 0;
+    for (Vec2 force : exact->forces) {
+        scale += force.length();
+    }
+    scale = std::max(scale / exact->forces.size(), 1e-9);
+
+    std::vector<double> errors;
+    double sum = 0;
+    for (int i = 0; i < (int)run->forces.size(); i += 1) {
+        Vec2 difference = run->forces[i].sub(exact->forces[i]);
+        double error = difference.length() / scale;
+        errors.push_back(error);
+        sum += error;
+    }
+    std::sort(errors.begin(), errors.end());
+    printf("%8.2f %12.2f %10.2fx %12.4f %12.4f %12.4f\n", opening, run->ms, exact->ms / run->ms, sum / errors.size(),
+           errors[errors.size() * 99 / 100], errors.back());
+}
+
+// Barnes-Hut opening angles against the exact tree, with a cohesion radius that covers the whole window
+int main(int argc, char *argv[]) {
+    int count = 100000;
+    int repeats = 3;
+    int threads = std::thread::hardware_concurrency();
+    float radius = 0;
+    Scenario scenario = SCENARIO_FLOCKS;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--boids") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--repeats") == 0) {
+            repeats = std::max(atoi(argv[i + 1]), 1);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--radius") == 0) {
+            radius = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--scenario") == 0) {
+            for (int k = 0; k < SCENARIO_COUNT; k += 1) {
+                if (strcmp(argv[i + 1], SCENARIO_NAMES[k]) == 0) {
+                    scenario = (Scenario)k;
+                }
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--boids N] [--repeats N] [--threads N] [--radius F]\n"
+                            "          [--scenario uniform|cluster|flocks|walls]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    BoundingBox bounds = scenario_bounds(count);
+    if (radius <= 0) {
+        radius = sqrt(bounds.width() * bounds.width() + bounds.height() * bounds.height());
+    }
+    printf("scenario: %s, boids: %d, radius: %.0f, threads: %d\n", SCENARIO_NAMES[scenario], count, radius, threads);
+    printf("%8s %12s %11s %12s %12s %12s\n", "opening", "forces ms", "speedup", "mean error", "p99 error",
+           "max error");
+
+    float openings[] = {0, 0.1, 0.25, 0.5, 0.75, 1};
+    Run exact = Run{};
+    for (float opening : openings) {
+        BoidManager manager = BoidManager{};
+        manager.params = BoidParams{
+            .boid_count = count,
+            .max_speed = 200,
+            .min_speed = 75,
+            .neighbor_distance = radius,
+            .separation_distance = 25,
+            .cohesion = 0.625,
+            .alignment = 2.5,
+            .separation = 1000,
+            .peripheral_angle = PI / 6,
+            .wall_distance = 300,
+            .wall_strength = 100000,
+        };
+        manager.engine = EngineParams{.threads = threads, .neighbors = NEIGHBORS_TREE, .opening_angle = opening};
+        manager.boids = generate_scenario(scenario, count, &bounds, manager.params.max_speed, 1);
+
+        Run run = run_forces(&manager, &bounds, repeats);
+        if (opening == 0) {
+            exact = run;
+        }
+        report(opening, &run, &exact);
+    }
+
+    return 0;
+}
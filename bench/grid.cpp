@@ -0,0 +1,139 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+#include "../src/boids.hpp"
+
+typedef struct LegacyPartition {
+    std::unordered_map<int, std::vector<Boid *>> map;
+    float cell_size;
+    int width;
+    int height;
+
+    static LegacyPartition build(float cell_size, BoundingBox *bounds) {
+        return LegacyPartition{
+            .cell_size = cell_size,
+            .width = (int)(bounds->height() / cell_size + 1),
+            .height = (int)(bounds->width() / cell_size + 1),
+        };
+    }
+
+    void insert(Boid *boid) {
+        this->map[this->boid_key(boid)].push_back(boid);
+    }
+
+    std::vector<Boid *> get_neighbors(Boid *target) {
+        std::vector<Boid *> neighbors;
+        int basex = target->position.x / this->cell_size;
+        int basey = target->position.y / this->cell_size;
+        for (int dx = -1; dx <= 1; dx += 1) {
+            for (int dy = -1; dy <= 1; dy += 1) {
+                int key = this->key(basex + dx, basey + dy);
+                if (this->map.count(key) == 0) {
+                    continue;
+                }
+                for (Boid *boid_ptr : this->map.at(key)) {
+                    neighbors.push_back(boid_ptr);
+                }
+            }
+        }
+
+        return neighbors;
+    }
+
+    int boid_key(Boid *boid) {
+        return this->key(boid->position.x / this->cell_size, boid->position.y / this->cell_size);
+    }
+
+    int key(int x, int y) {
+        return y * this->height + x;
+    }
+} LegacyPartition;
+
+typedef struct Timing {
+    double build_ms;
+    double query_ms;
+    long long candidates;
+} Timing;
+
+double elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+Timing time_legacy(std::vector<Boid> &boids, BoundingBox *bounds, float cell_size) {
+    Timing timing = Timing{};
+    auto start = std::chrono::steady_clock::now();
+    LegacyPartition grid = LegacyPartition::build(cell_size, bounds);
+    for (Boid &boid : boids) {
+        grid.insert(&boid);
+    }
+    timing.build_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    for (Boid &boid : boids) {
+        timing.candidates += grid.get_neighbors(&boid).size();
+    }
+    timing.query_ms = elapsed_ms(start);
+    return timing;
+}
+
+Timing time_flat(std::vector<Boid> &boids, BoundingBox *bounds, float cell_size, SpatialPartition *grid) {
+    Timing timing = Timing{};
+    auto start = std::chrono::steady_clock::now();
+    grid->resize(cell_size, bounds, false);
+    grid->populate(boids);
+    timing.build_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    long long candidates = 0;
+    for (Boid &boid : boids) {
+        grid->for_each_neighbor(&boid.position, [&](int, const Vec2 &) { candidates += 1; });
+    }
+    timing.query_ms = elapsed_ms(start);
+    timing.candidates = candidates;
+    return timing;
+}
+
+int main(int argc, char *argv[]) {
+    int counts[] = {10000, 100000, 1000000};
+    float cell_size = 200;
+    // the default window holds 500 boids in 1920x1080; the bounds grow with the count to keep that density
+    float density = 500 / (1920.0 * 1080.0);
+    int repeats = argc > 1 ? atoi(argv[1]) : 3;
+
+    printf("%10s %12s %12s %12s %12s %10s\n", "boids", "legacy ms", "flat ms", "build x", "query x", "total x");
+    for (int count : counts) {
+        float side = sqrt(count / density / (16.0 / 9.0));
+        BoundingBox bounds = BoundingBox{.xmin = 0, .xmax = side * 16 / 9, .ymin = 0, .ymax = side};
+
+        srand(1);
+        std::vector<Boid> boids;
+        for (int i = 0; i < count; i += 1) {
+            Vec2 position = Vec2::build((float)rand() / RAND_MAX * bounds.xmax, (float)rand() / RAND_MAX * bounds.ymax);
+            boids.push_back(Boid::build(position, Vec2::zeros()));
+        }
+
+        Timing legacy = Timing{.build_ms = 1e30, .query_ms = 1e30};
+        Timing flat = Timing{.build_ms = 1e30, .query_ms = 1e30};
+        SpatialPartition grid = SpatialPartition{};
+        for (int r = 0; r < repeats; r += 1) {
+            Timing sample = time_legacy(boids, &bounds, cell_size);
+            legacy.build_ms = fmin(legacy.build_ms, sample.build_ms);
+            legacy.query_ms = fmin(legacy.query_ms, sample.query_ms);
+            legacy.candidates = sample.candidates;
+
+            sample = time_flat(boids, &bounds, cell_size, &grid);
+            flat.build_ms = fmin(flat.build_ms, sample.build_ms);
+            flat.query_ms = fmin(flat.query_ms, sample.query_ms);
+            flat.candidates = sample.candidates;
+        }
+
+        double legacy_total = legacy.build_ms + legacy.query_ms;
+        double flat_total = flat.build_ms + flat.query_ms;
+        printf("%10d %12.2f %12.2f %12.2f %12.2f %10.2f\n", count, legacy_total, flat_total,
+               legacy.build_ms / flat.build_ms, legacy.query_ms / flat.query_ms, legacy_total / flat_total);
+    }
+
+    return 0;
+}
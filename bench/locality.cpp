@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "scenarios.hpp"
+
+// one hardware counter on the calling thread, `available` is false where perf events are missing or not permitted
+typedef struct CacheCounter {
+    int fd;
+    bool available;
+
+    static CacheCounter open(unsigned int type, unsigned long long config) {
+        CacheCounter counter = CacheCounter{.fd = -1, .available = false};
+#if defined(__linux__)
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        counter.fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        counter.available = counter.fd >= 0;
+#endif
+        return counter;
+    }
+
+    static CacheCounter l1_misses() {
+#if defined(__linux__)
+        return CacheCounter::open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+        return CacheCounter::open(0, 0);
+#endif
+    }
+
+    static CacheCounter llc_misses() {
+#if defined(__linux__)
+        return CacheCounter::open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+        return CacheCounter::open(0, 0);
+#endif
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (this->available) {
+            ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+        long long value = -1;
+#if defined(__linux__)
+        if (this->available) {
+            ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(this->fd, &value, sizeof(value)) != sizeof(value)) {
+                value = -1;
+            }
+        }
+#endif
+        return value;
+    }
+} CacheCounter;
+
+typedef struct Sample {
+    double ms_per_step;
+    long long l1_misses;
+    long long llc_misses;
+} Sample;
+
+// single-threaded, so counters opened on this thread see every access of the step
+Sample measure(BoidManager *manager, BoundingBox *bounds, int steps, CacheCounter *l1, CacheCounter *llc) {
+    manager->update_boids(bounds, 0.05);
+
+    l1->start();
+    llc->start();
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step += 1) {
+        manager->update_boids(bounds, 0.05);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return Sample{.ms_per_step = ms / steps, .l1_misses = l1->stop(), .llc_misses = llc->stop()};
+}
+
+void print_misses(long long misses, int steps, int count) {
+    if (misses < 0) {
+        printf(" %14s", "unavailable");
+    } else {
+        printf(" %14.2f", (double)misses / steps / count);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *kernels[] = {"reference", "soa", "simd"};
+    std::vector<int> counts = {100000, 1000000};
+    int steps = 3;
+    int interval = 10;
+    Kernel kernel = KERNEL_REFERENCE;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--counts") == 0) {
+            counts.clear();
+            for (const char *cursor = argv[i + 1]; cursor != nullptr; cursor = strchr(cursor, ',')) {
+                cursor += *cursor == ',';
+                counts.push_back(atoi(cursor));
+            }
+        } else if (strcmp(argv[i], "--steps") == 0) {
+            steps = std::max(atoi(argv[i + 1]), 1);
+        } else if (strcmp(argv[i], "--interval") == 0) {
+            interval = std::max(atoi(argv[i + 1]), 1);
+        } else if (strcmp(argv[i], "--kernel") == 0) {
+            for (int k = 0; k < 3; k += 1) {
+                if (strcmp(argv[i + 1], kernels[k]) == 0) {
+                    kernel = (Kernel)k;
+                }
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--counts 100000,1000000] [--steps N] [--interval STEPS]\n"
+                            "          [--kernel reference|soa|simd]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    CacheCounter l1 = CacheCounter::l1_misses();
+    CacheCounter llc = CacheCounter::llc_misses();
+    if (!l1.available || !llc.available) {
+        printf("hardware cache counters unavailable (perf_event_open: %s), reporting time only\n", strerror(errno));
+    }
+
+    printf("scenario: %s, kernel: %s, steps: %d, reorder interval: %d, threads: 1\n", SCENARIO_NAMES[SCENARIO_UNIFORM],
+           kernels[kernel], steps, interval);
+    printf("%10s %8s %12s %14s %14s\n", "boids", "order", "ms/step", "L1 miss/boid", "LLC miss/boid");
+    for (int count : counts) {
+        BoundingBox bounds = scenario_bounds(count);
+        for (int reorder = 0; reorder <= 1; reorder += 1) {
+            BoidManager manager = BoidManager{};
+            manager.params = BoidParams{
+                .boid_count = count,
+                .max_speed = 200,
+                .min_speed = 75,
+                .neighbor_distance = 200,
+                .separation_distance = 50,
+                .cohesion = 0.625,
+                .alignment = 2.5,
+                .separation = 1000,
+                .peripheral_angle = PI / 6,
+                .wall_distance = 300,
+                .wall_strength = 100000,
+            };
+            manager.engine = EngineParams{
+                .kernel = kernel,
+                .threads = 1,
+                .reorder_interval = reorder ? interval : 0,
+            };
+            manager.boids = generate_scenario(SCENARIO_UNIFORM, count, &bounds, manager.params.max_speed, 1);
+
+            Sample sample = measure(&manager, &bounds, steps, &l1, &llc);
+            printf("%10d %8s %12.2f", count, reorder ? "morton" : "spawn", sample.ms_per_step);
+            print_misses(sample.l1_misses, steps, count);
+            print_misses(sample.llc_misses, steps, count);
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "scenarios.hpp"
+
+// median wall time of one update_boids step
+double time_step(BoidManager *manager, BoundingBox *bounds, int steps) {
+    std::vector<double> samples;
+    manager->update_boids(bounds, 0.05);
+    for (int step = 0; step < steps; step += 1) {
+        auto start = std::chrono::steady_clock::now();
+        manager->update_boids(bounds, 0.05);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// a fixed flock packed into ever smaller bounds, every boid steering by all it sees against only its nearest few
+int main(int argc, char *argv[]) {
+    const char *kernels[] = {"reference", "soa", "simd"};
+    int count = 20000;
+    int steps = 3;
+    int threads = std::thread::hardware_concurrency();
+    int nearest = 7;
+    Kernel kernel = KERNEL_SIMD;
+    Scenario scenario = SCENARIO_UNIFORM;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--boids") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--steps") == 0) {
+            steps = std::max(atoi(argv[i + 1]), 1);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--nearest") == 0) {
+            nearest = std::clamp(atoi(argv[i + 1]), 1, NEAREST_LIMIT);
+        } else if (strcmp(argv[i], "--scenario") == 0) {
+            for (int k = 0; k < SCENARIO_COUNT; k += 1) {
+                if (strcmp(argv[i + 1], SCENARIO_NAMES[k]) == 0) {
+                    scenario = (Scenario)k;
+                }
+            }
+        } else if (strcmp(argv[i], "--kernel") == 0) {
+            for (int k = 0; k < 3; k += 1) {
+                if (strcmp(argv[i + 1], kernels[k]) == 0) {
+                    kernel = (Kernel)k;
+                }
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--boids N] [--steps N] [--threads N] [--nearest K]\n"
+                            "          [--scenario uniform|cluster|flocks|walls] [--kernel reference|soa|simd]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    printf("scenario: %s, boids: %d, nearest: %d, kernel: %s, threads: %d\n", SCENARIO_NAMES[scenario], count,
+           nearest, kernels[kernel], threads);
+    // a capped step should hold flat from where the cap is below the boids in reach, looking at about as many
+    // boids per boid however dense the flock
+    printf("%8s %12s %12s %12s %12s\n", "density", "in reach", "all ms", "nearest ms", "looked at");
+    for (int density = 1; density <= 256; density *= 2) {
+        // the bounds of a flock `density` times smaller at the default density hold this one that much denser
+        BoundingBox bounds = scenario_bounds(std::max(count / density, 1));
+        double ms[2];
+        long long pairs = 0;
+        int caps[2] = {0, nearest};
+        for (int m = 0; m < 2; m += 1) {
+            BoidManager manager = BoidManager{};
+            manager.params = BoidParams{
+                .boid_count = count,
+                .max_speed = 200,
+                .min_speed = 75,
+                .neighbor_distance = 100,
+                .separation_distance = 25,
+                .cohesion = 0.625,
+                .alignment = 2.5,
+                .separation = 1000,
+                .peripheral_angle = PI / 6,
+                .wall_distance = 150,
+                .wall_strength = 100000,
+                .nearest_neighbors = caps[m],
+            };
+            manager.engine = EngineParams{.kernel = kernel, .threads = threads};
+            manager.boids = generate_scenario(scenario, count, &bounds, manager.params.max_speed, 1);
+            ms[m] = time_step(&manager, &bounds, steps);
+            for (int worker = 0; worker < (int)manager.scheduler.counters.size() && m == 1; worker += 1) {
+                pairs += manager.scheduler.counters[worker].pairs;
+            }
+        }
+        float in_reach = count * PI * 100 * 100 / (bounds.width() * bounds.height());
+        printf("%8d %12.0f %12.2f %12.2f %12.0f\n", density, in_reach, ms[0], ms[1], (double)pairs / count);
+    }
+
+    return 0;
+}
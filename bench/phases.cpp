@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "scenarios.hpp"
+
+typedef struct PhaseTimes {
+    double populate_map;
+    double neighbors;
+    double forces;
+    double integrate;
+    double migrated;
+} PhaseTimes;
+
+typedef struct Options {
+    std::vector<int> counts;
+    std::vector<float> distances;
+    int steps;
+    int threads;
+    float delta_time;
+    Kernel kernel;
+    GridUpdate grid;
+    const char *output;
+} Options;
+
+std::vector<int> parse_ints(const char *list) {
+    std::vector<int> values;
+    for (const char *cursor = list; *cursor != 0;) {
+        values.push_back(atoi(cursor));
+        const char *comma = strchr(cursor, ',');
+        cursor = comma ? comma + 1 : cursor + strlen(cursor);
+    }
+    return values;
+}
+
+std::vector<float> parse_floats(const char *list) {
+    std::vector<float> values;
+    for (int value : parse_ints(list)) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// each sample is one full update_boids step, timed phase by phase
+PhaseTimes measure(BoidManager *manager, BoundingBox *bounds, int steps, float delta_time, long long *candidates) {
+    std::vector<double> populate_map, neighbors, forces, integrate, migrated;
+    for (int step = 0; step < steps; step += 1) {
+        auto start = std::chrono::steady_clock::now();
+        manager->populate_map(bounds);
+        populate_map.push_back(since(start));
+        migrated.push_back(manager->grid.migrated_fraction());
+
+        start = std::chrono::steady_clock::now();
+        long long visited = 0;
+        for (Boid &boid : manager->boids) {
+            manager->grid.for_each_neighbor(&boid.position, [&](int, const Vec2 &) { visited += 1; });
+        }
+        neighbors.push_back(since(start));
+        *candidates = visited;
+
+        start = std::chrono::steady_clock::now();
+        manager->accumulate_forces(bounds);
+        forces.push_back(since(start));
+
+        start = std::chrono::steady_clock::now();
+        manager->integrate_boids(bounds, delta_time);
+        integrate.push_back(since(start));
+    }
+
+    double count = manager->boids.size();
+    return PhaseTimes{
+        .populate_map = median(populate_map) / count,
+        .neighbors = median(neighbors) / count,
+        .forces = median(forces) / count,
+        .integrate = median(integrate) / count,
+        .migrated = median(migrated),
+    };
+}
+
+int main(int argc, char *argv[]) {
+    const char *kernels[] = {"reference", "soa", "simd"};
+    const char *grids[] = {"rebuild", "incremental"};
+    Options options = Options{
+        .counts = {1000, 10000, 100000, 1000000},
+        .distances = {50, 100, 200},
+        .steps = 5,
+        .threads = (int)std::thread::hardware_concurrency(),
+        .delta_time = 0.05,
+        .kernel = KERNEL_SIMD,
+        .grid = GRID_REBUILD,
+        .output = nullptr,
+    };
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--counts") == 0) {
+            options.counts = parse_ints(argv[i + 1]);
+        } else if (strcmp(argv[i], "--distances") == 0) {
+            options.distances = parse_floats(argv[i + 1]);
+        } else if (strcmp(argv[i], "--steps") == 0) {
+            options.steps = std::max(atoi(argv[i + 1]), 1);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            options.threads = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--dt") == 0) {
+            options.delta_time = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--kernel") == 0) {
+            for (int k = 0; k < 3; k += 1) {
+                if (strcmp(argv[i + 1], kernels[k]) == 0) {
+                    options.kernel = (Kernel)k;
+                }
+            }
+        } else if (strcmp(argv[i], "--grid") == 0) {
+            for (int g = 0; g < 2; g += 1) {
+                if (strcmp(argv[i + 1], grids[g]) == 0) {
+                    options.grid = (GridUpdate)g;
+                }
+            }
+        } else if (strcmp(argv[i], "--out") == 0) {
+            options.output = argv[i + 1];
+        } else {
+            fprintf(stderr, "usage: %s [--counts 1000,10000] [--distances 50,100] [--steps N] [--threads N] [--dt SECONDS]\n"
+                            "          [--kernel reference|soa|simd] [--grid rebuild|incremental] [--out results.json]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *json = options.output ? fopen(options.output, "w") : stdout;
+    if (json == nullptr) {
+        fprintf(stderr, "cannot open %s\n", options.output);
+        return 1;
+    }
+
+    fprintf(json, "{\n  \"kernel\": \"%s\",\n  \"grid\": \"%s\",\n  \"threads\": %d,\n  \"steps\": %d,\n  \"dt\": %g,\n  \"results\": [",
+            kernels[options.kernel], grids[options.grid], options.threads, options.steps, options.delta_time);
+    fprintf(stderr, "%-8s %8s %6s %10s %10s %10s %10s %10s  (ns/boid)\n", "scenario", "boids", "radius", "populate",
+            "neighbors", "forces", "integrate", "step");
+
+    bool first = true;
+    for (int scenario = 0; scenario < SCENARIO_COUNT; scenario += 1) {
+        for (int count : options.counts) {
+            for (float distance : options.distances) {
+                BoundingBox bounds = scenario_bounds(count);
+                BoidManager manager = BoidManager{};
+                manager.params = BoidParams{
+                    .boid_count = count,
+                    .max_speed = 200,
+                    .min_speed = 75,
+                    .neighbor_distance = distance,
+                    .separation_distance = distance / 4,
+                    .cohesion = 0.625,
+                    .alignment = 2.5,
+                    .separation = 1000,
+                    .peripheral_angle = PI / 6,
+                    .wall_distance = 300,
+                    .wall_strength = 100000,
+                };
+                manager.engine = EngineParams{.kernel = options.kernel, .threads = options.threads, .grid = options.grid};
+                manager.boids = generate_scenario((Scenario)scenario, count, &bounds, manager.params.max_speed, 1);
+
+                long long candidates = 0;
+                PhaseTimes times = measure(&manager, &bounds, options.steps, options.delta_time, &candidates);
+                double step = times.populate_map + times.forces + times.integrate;
+
+                fprintf(stderr, "%-8s %8d %6.0f %10.1f %10.1f %10.1f %10.1f %10.1f\n", SCENARIO_NAMES[scenario], count,
+                        distance, times.populate_map, times.neighbors, times.forces, times.integrate, step);
+                fprintf(json,
+                        "%s\n    {\"scenario\": \"%s\", \"boids\": %d, \"neighbor_distance\": %g, "
+                        "\"candidates_per_boid\": %.2f, \"migrated_fraction\": %.4f, \"ns_per_boid\": {\"populate_map\": %.2f, "
+                        "\"get_neighbors\": %.2f, \"forces\": %.2f, \"integrate\": %.2f, \"step\": %.2f}}",
+                        first ? "" : ",", SCENARIO_NAMES[scenario], count, distance, (double)candidates / count,
+                        times.migrated, times.populate_map, times.neighbors, times.forces, times.integrate, step);
+                first = false;
+            }
+        }
+    }
+    fprintf(json, "\n  ]\n}\n");
+
+    if (json != stdout) {
+        fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#ifndef SCENARIOS_H
+#define SCENARIOS_H
+
+#include <cstdlib>
+#include <vector>
+
+#include "../src/boids.hpp"
+
+typedef enum Scenario {
+    SCENARIO_UNIFORM,
+    SCENARIO_CLUSTER,
+    SCENARIO_FLOCKS,
+    SCENARIO_WALLS,
+    SCENARIO_COUNT,
+} Scenario;
+
+static const char *SCENARIO_NAMES[SCENARIO_COUNT] = {"uniform", "cluster", "flocks", "walls"};
+
+// the default window holds 500 boids in 1920x1080; the bounds grow with the count to keep that density
+static const float SCENARIO_DENSITY = 500 / (1920.0 * 1080.0);
+
+float random_unit() {
+    return (float)rand() / RAND_MAX;
+}
+
+Vec2 random_heading(float speed) {
+    float angle = random_unit() * TAU;
+    return Vec2::build(cos(angle), sin(angle)).mul(speed);
+}
+
+BoundingBox scenario_bounds(int count) {
+    float height = sqrt(count / SCENARIO_DENSITY / (16.0 / 9.0));
+    return BoundingBox{.xmin = 0, .xmax = height * 16 / 9, .ymin = 0, .ymax = height};
+}
+
+// uniform: spread over the whole box
+// cluster: one disk with 20x the average density in the middle of the box
+// flocks: groups of 50 sharing a heading, scattered over the box
+// walls: everyone within 30 units of an edge, running along it
+std::vector<Boid> generate_scenario(Scenario scenario, int count, BoundingBox *bounds, float speed, int seed) {
+    srand(seed);
+    std::vector<Boid> boids;
+    boids.reserve(count);
+
+    Vec2 center = Vec2::build((bounds->xmin + bounds->xmax) / 2, (bounds->ymin + bounds->ymax) / 2);
+    float cluster_radius = sqrt(bounds->width() * bounds->height() / 20 / PI);
+    Vec2 flock_center = Vec2::zeros();
+    Vec2 flock_heading = Vec2::zeros();
+
+    for (int i = 0; i < count; i += 1) {
+        Vec2 position = Vec2::build(bounds->xmin + random_unit() * bounds->width(),
+                                    bounds->ymin + random_unit() * bounds->height());
+        Vec2 velocity = random_heading(speed);
+
+        switch (scenario) {
+        case SCENARIO_UNIFORM:
+        case SCENARIO_COUNT:
+            break;
+        case SCENARIO_CLUSTER:
+            position = center.add(random_heading(cluster_radius * sqrt(random_unit())));
+            break;
+        case SCENARIO_FLOCKS:
+            if (i % 50 == 0) {
+                flock_center = position;
+                flock_heading = velocity;
+            }
+            position = flock_center.add(random_heading(40 * sqrt(random_unit())));
+            velocity = flock_heading.add(random_heading(speed * 0.1));
+            break;
+        case SCENARIO_WALLS: {
+            float inset = random_unit() * 30;
+            switch (i % 4) {
+            case 0:
+                position.x = bounds->xmin + inset;
+                velocity = Vec2::build(0, speed);
+                break;
+            case 1:
+                position.x = bounds->xmax - inset;
+                velocity = Vec2::build(0, -speed);
+                break;
+            case 2:
+                position.y = bounds->ymin + inset;
+                velocity = Vec2::build(-speed, 0);
+                break;
+            case 3:
+                position.y = bounds->ymax - inset;
+                velocity = Vec2::build(speed, 0);
+                break;
+            }
+            break;
+        }
+        }
+
+        position.x = std::clamp(position.x, bounds->xmin + 1, bounds->xmax - 1);
+        position.y = std::clamp(position.y, bounds->ymin + 1, bounds->ymax - 1);
+        boids.push_back(Boid::build(position, velocity));
+    }
+
+    return boids;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "scenarios.hpp"
+
+// median wall time of one update_boids step
+double time_step(BoidManager *manager, BoundingBox *bounds, int steps) {
+    std::vector<double> samples;
+    manager->update_boids(bounds, 0.05);
+    for (int step = 0; step < steps; step += 1) {
+        auto start = std::chrono::steady_clock::now();
+        manager->update_boids(bounds, 0.05);
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// grid against tree for a growing cohesion radius over a fixed separation radius, and what NEIGHBORS_AUTO picks
+int main(int argc, char *argv[]) {
+    const char *kernels[] = {"reference", "soa", "simd"};
+    int count = 100000;
+    int steps = 3;
+    int threads = std::thread::hardware_concurrency();
+    float separation = 25;
+    Kernel kernel = KERNEL_SIMD;
+    Scenario scenario = SCENARIO_UNIFORM;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--boids") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--steps") == 0) {
+            steps = std::max(atoi(argv[i + 1]), 1);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--separation") == 0) {
+            separation = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--scenario") == 0) {
+            for (int k = 0; k < SCENARIO_COUNT; k += 1) {
+                if (strcmp(argv[i + 1], SCENARIO_NAMES[k]) == 0) {
+                    scenario = (Scenario)k;
+                }
+            }
+        } else if (strcmp(argv[i], "--kernel") == 0) {
+            for (int k = 0; k < 3; k += 1) {
+                if (strcmp(argv[i + 1], kernels[k]) == 0) {
+                    kernel = (Kernel)k;
+                }
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--boids N] [--steps N] [--threads N] [--separation F]\n"
+                            "          [--scenario uniform|cluster|flocks|walls] [--kernel reference|soa|simd]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    BoundingBox bounds = scenario_bounds(count);
+    printf("scenario: %s, boids: %d, separation: %.0f, grid kernel: %s, threads: %d\n",
+           SCENARIO_NAMES[scenario], count, separation, kernels[kernel], threads);
+    printf("%6s %8s %12s %12s %6s\n", "ratio", "radius", "grid ms", "tree ms", "auto");
+    for (int ratio = 1; ratio <= 32; ratio *= 2) {
+        double ms[2];
+        NeighborMode modes[2] = {NEIGHBORS_GRID, NEIGHBORS_TREE};
+        BoidManager manager = BoidManager{};
+        for (int m = 0; m < 2; m += 1) {
+            manager = BoidManager{};
+            manager.params = BoidParams{
+                .boid_count = count,
+                .max_speed = 200,
+                .min_speed = 75,
+                .neighbor_distance = separation * ratio,
+                .separation_distance = separation,
+                .cohesion = 0.625,
+                .alignment = 2.5,
+                .separation = 1000,
+                .peripheral_angle = PI / 6,
+                .wall_distance = 300,
+                .wall_strength = 100000,
+            };
+            manager.engine = EngineParams{.kernel = kernel, .threads = threads, .neighbors = modes[m]};
+            manager.boids = generate_scenario(scenario, count, &bounds, manager.params.max_speed, 1);
+            ms[m] = time_step(&manager, &bounds, steps);
+        }
+        manager.engine.neighbors = NEIGHBORS_AUTO;
+        printf("%6d %8.0f %12.2f %12.2f %6s\n", ratio, separation * ratio, ms[0], ms[1],
+               manager.neighbor_mode() == NEIGHBORS_TREE ? "tree" : "grid");
+    }
+
+    return 0;
+}
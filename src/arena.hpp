@@ -0,0 +1,39 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// bump allocator for scratch that lives for one pass of a step: `take` only moves a cursor and `reset` drops
+// everything at once. A pass that runs past the block spills into blocks of its own, and the next reset grows the
+// block to the high-water mark, so once the flock stops growing the arena stops allocating
+typedef struct FrameArena {
+    std::vector<char> block;
+    std::vector<std::vector<char>> spills;
+    size_t used;
+    long long growths;
+
+    // uninitialized room for `count` trivially copyable T
+    template <typename T> T *take(int count) {
+        size_t bytes = sizeof(T) * (size_t)count;
+        size_t offset = (this->used + alignof(T) - 1) / alignof(T) * alignof(T);
+        this->used = offset + bytes;
+        if (this->used <= this->block.size()) {
+            return (T *)(this->block.data() + offset);
+        }
+        // operator new memory is aligned for any fundamental type
+        this->spills.push_back(std::vector<char>(bytes > 0 ? bytes : 1));
+        return (T *)this->spills.back().data();
+    }
+
+    void reset() {
+        if (this->used > this->block.size()) {
+            this->block = std::vector<char>(this->used + this->used / 4);
+            this->growths += 1;
+        }
+        this->spills.clear();
+        this->used = 0;
+    }
+} FrameArena;
+
+#endif
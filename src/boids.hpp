@@ -4,27 +4,27 @@
 #define PI 3.141592
 #define TAU PI * 2
 
-#include <unordered_map>
+#include <algorithm>
+#include <memory>
 #include <vector>
 
+#include "arena.hpp"
+#include "isa.hpp"
+#include "profiler.hpp"
+#include "random.hpp"
+#include "scheduler.hpp"
+#include "simd.hpp"
+#include "sort.hpp"
+#include "threads.hpp"
 #include "vector.hpp"
 
-typedef struct VectorData {
-    Vec2 vector;
-    float length;
-
-    static VectorData build(Vec2 vector) {
-        return VectorData{.vector = vector, .length = vector.length()};
-    }
-} VectorData;
-
 typedef struct BoundingBox {
     float xmin;
     float xmax;
     float ymin;
     float ymax;
 
-    Vec2 box_wrapped_postion(const Vec2 *from, const Vec2 *to) {
+    Vec2 box_wrapped_postion(const Vec2 *from, const Vec2 *to) const {
         float x_range = this->xmax - this->xmin;
         float y_range = this->ymax - this->ymin;
 
@@ -45,11 +45,11 @@ typedef struct BoundingBox {
         return direct;
     }
 
-    float width() {
+    float width() const {
         return this->xmax - this->xmin;
     }
 
-    float height() {
+    float height() const {
         return this->ymax - this->ymin;
     }
 } BoundingBox;
@@ -68,18 +68,19 @@ typedef struct BoidParams {
     float peripheral_angle;
     float wall_distance;
     float wall_strength;
+    // 0 steers by every visible boid in range; above it only by the nearest ones, at most NEAREST_LIMIT, so a dense
+    // flock costs no more per boid than a sparse one. The tree aggregates far boids and ignores it
+    int nearest_neighbors;
 } BoidParams;
 
 typedef struct Boid {
     Vec2 position;
     Vec2 velocity;
-    Vec2 acceleration;
 
     static Boid build(Vec2 pos, Vec2 vel) {
         return Boid{
             .position = pos,
             .velocity = vel,
-            .acceleration = Vec2::zeros(),
         };
     }
 
@@ -87,12 +88,16 @@ typedef struct Boid {
         this->position.add_assign(this->velocity.mul(delta_time));
     }
 
-    void integrate(float delta_time) {
-        this->velocity.add_assign(this->acceleration.mul(delta_time));
+    // periodic edges: a boid leaving one side comes back in on the other, keeping its velocity
+    void wrap(BoundingBox *bounds) {
+        float width = bounds->width();
+        float height = bounds->height();
+        this->position.x -= width * floor((this->position.x - bounds->xmin) / width);
+        this->position.y -= height * floor((this->position.y - bounds->ymin) / height);
     }
 
-    void reset_forces() {
-        this->acceleration.mul_assign(0);
+    void integrate(Vec2 acceleration, float delta_time) {
+        this->velocity.add_assign(acceleration.mul(delta_time));
     }
 
     void contain(BoundingBox *bounds) {
@@ -123,7 +128,7 @@ typedef struct Boid {
         }
     }
 
-    void avoid_walls(BoundingBox *bounds, BoidParams *params) {
+    Vec2 wall_repulsion(const BoundingBox *bounds, const BoidParams *params) const {
         Vec2 repulsion = Vec2::zeros();
         if (this->position.x < bounds->xmin + params->wall_distance) {
             float distance = this->position.x - bounds->xmin;
@@ -141,176 +146,1688 @@ typedef struct Boid {
             float distance = bounds->ymax - this->position.y;
             repulsion.y -= params->wall_strength / (distance * distance);
         }
+        return repulsion;
+    }
+} Boid;
+
+// a run of adjacent columns (or rows) in a cell's stencil, and the offset that brings their boids next to the cell
+// when the run lies across a wrapped edge
+typedef struct StencilSpan {
+    int first;
+    int last;
+    float shift;
+} StencilSpan;
 
-        this->acceleration.add_assign(repulsion);
+// `offset` along a wrapped axis of `length` taken to its nearest image, as box_wrapped_postion takes it
+static float nearest_offset(float offset, float length) {
+    if (offset > length / 2) {
+        return offset - length;
     }
+    if (offset < -length / 2) {
+        return offset + length;
+    }
+    return offset;
+}
+
+// whether a wrapped axis is too short for a stencil of `cell_size` cells to bring in the far side as shifted
+// images; the stencil then covers the whole axis unshifted, and each pair takes its nearest image on its own
+static bool folds_axis(float length, float cell_size) {
+    return (int)(length / cell_size) < 3;
+}
+
+// whether the `cells` cells of a wrapped axis, centered on a boid's own, leave the far image of a cell within `reach`
+// of it: the window reaches only whole cells past the boid's own on its shorter side, and an even count puts the same
+// cells at both ends
+static bool blurs_images(int cells, float cell_size, float reach) {
+    return ((cells + 1) / 2 - 1) * cell_size <= reach;
+}
 
-    void cohesion(VectorData *pointer, Vec2 *force, int *counter, BoidParams *params) {
-        if (pointer->length > params->neighbor_distance) {
+// each cell's stencil along one axis as two runs; the second is empty unless the axis wraps and the cell is on an edge
+static void stencil_spans(std::vector<StencilSpan> *spans, int cells, float length, bool wrap) {
+    spans->resize(cells * 2);
+    for (int cell = 0; cell < cells; cell += 1) {
+        (*spans)[cell * 2] = StencilSpan{.first = std::max(cell - 1, 0), .last = std::min(cell + 1, cells - 1)};
+        (*spans)[cell * 2 + 1] = StencilSpan{.first = 0, .last = -1};
+        // with fewer than three cells the stencil already holds the whole axis, see folds_axis
+        if (!wrap || cells < 3) {
+            continue;
+        }
+        if (cell == 0) {
+            (*spans)[cell * 2 + 1] = StencilSpan{.first = cells - 1, .last = cells - 1, .shift = -length};
+        } else if (cell == cells - 1) {
+            (*spans)[cell * 2 + 1] = StencilSpan{.first = 0, .last = 0, .shift = length};
+        }
+    }
+}
+
+typedef struct SpatialPartition {
+    std::vector<int> cell_start;
+    std::vector<int> cell_count;
+    std::vector<int> indices;
+    std::vector<int> boid_cells;
+    float cell_size;
+    float cell_width;
+    float cell_height;
+    float xmin;
+    float ymin;
+    int width;
+    int height;
+
+    // precomputed stencils, two spans per column and per row, so lookups never test for the edges
+    std::vector<StencilSpan> columns;
+    std::vector<StencilSpan> rows;
+    bool wrap;
+    // on a torus, the bounds' size, and whether an axis has too few cells to wrap through the stencil
+    float length_x;
+    float length_y;
+    bool fold_x;
+    bool fold_y;
+
+    // incremental mode only: every boid's slot within its cell, and scratch for moving boids between layouts
+    std::vector<int> boid_slots;
+    int *moved;
+    int *moved_to;
+    int moved_count;
+    std::vector<int> cell_arrivals;
+    std::vector<int> next_start;
+    std::vector<int> next_indices;
+    int migrated;
+    bool tracking;
+
+    static SpatialPartition build(float cell_size, BoundingBox *bounds, bool wrap) {
+        SpatialPartition partition = SpatialPartition{};
+        partition.resize(cell_size, bounds, wrap);
+        return partition;
+    }
+
+    // returns whether the cell layout changed, which invalidates the layout `update` keeps from the last step;
+    // a wrapped grid is cut into whole cells at least `cell_size` wide, so no pair in reach skips a cell across the edge
+    bool resize(float cell_size, BoundingBox *bounds, bool wrap) {
+        int width = (int)(bounds->width() / cell_size + 1);
+        int height = (int)(bounds->height() / cell_size + 1);
+        if (wrap) {
+            width = std::max((int)(bounds->width() / cell_size), 1);
+            height = std::max((int)(bounds->height() / cell_size), 1);
+        }
+        float cell_width = wrap ? fmax(bounds->width() / width, cell_size) : cell_size;
+        float cell_height = wrap ? fmax(bounds->height() / height, cell_size) : cell_size;
+        bool changed = cell_size != this->cell_size || cell_width != this->cell_width ||
+                       cell_height != this->cell_height || bounds->xmin != this->xmin || bounds->ymin != this->ymin ||
+                       width != this->width || height != this->height || wrap != this->wrap;
+        this->cell_size = cell_size;
+        this->cell_width = cell_width;
+        this->cell_height = cell_height;
+        this->xmin = bounds->xmin;
+        this->ymin = bounds->ymin;
+        this->width = width;
+        this->height = height;
+        this->wrap = wrap;
+        this->length_x = bounds->width();
+        this->length_y = bounds->height();
+        this->fold_x = wrap && folds_axis(bounds->width(), cell_size);
+        this->fold_y = wrap && folds_axis(bounds->height(), cell_size);
+        this->cell_start.resize(this->cell_total() + 2);
+        this->cell_count.resize(this->cell_total() + 1);
+        if (changed || this->columns.empty()) {
+            stencil_spans(&this->columns, width, bounds->width(), wrap);
+            stencil_spans(&this->rows, height, bounds->height(), wrap);
+        }
+        return changed;
+    }
+
+    // counting sort: boids end up grouped by cell in `indices`, in their original order within a cell
+    void populate(const std::vector<Boid> &boids) {
+        int count = boids.size();
+        this->boid_cells.resize(count);
+        for (int i = 0; i < count; i += 1) {
+            this->boid_cells[i] = this->boid_key(&boids[i]);
+        }
+        this->sort_binned();
+    }
+
+    // the counting sort of `populate` over keys already in `boid_cells`, one per boid
+    void sort_binned() {
+        int count = this->boid_cells.size();
+        this->indices.resize(count);
+        this->tracking = false;
+        std::fill(this->cell_count.begin(), this->cell_count.end(), 0);
+
+        for (int i = 0; i < count; i += 1) {
+            this->cell_count[this->boid_cells[i]] += 1;
+        }
+
+        int running = 0;
+        for (int cell = 0; cell <= this->cell_total(); cell += 1) {
+            running += this->cell_count[cell];
+            this->cell_start[cell] = running;
+        }
+        this->cell_start[this->cell_total() + 1] = running;
+
+        for (int i = count - 1; i >= 0; i -= 1) {
+            int cell = this->boid_cells[i];
+            this->cell_start[cell] -= 1;
+            this->indices[this->cell_start[cell]] = i;
+        }
+    }
+
+    // keeps last step's layout and only moves boids whose cell changed: they are swap-removed from their old
+    // cell, survivors are copied cell by cell into the new layout and arrivals appended behind them; boids
+    // keep arrival order within a cell rather than index order
+    void update(const std::vector<Boid> &boids, bool reset, FrameArena *arena) {
+        int count = boids.size();
+        if (reset || !this->tracking) {
+            this->populate(boids);
+            this->boid_slots.resize(count);
+            for (int cell = 0; cell <= this->cell_total(); cell += 1) {
+                for (int k = 0; k < this->cell_count[cell]; k += 1) {
+                    this->boid_slots[this->indices[this->cell_start[cell] + k]] = k;
+                }
+            }
+            this->cell_arrivals.assign(this->cell_count.size(), 0);
+            this->tracking = true;
+            this->migrated = count;
             return;
         }
 
-        *counter += 1;
-        force->add_assign(pointer->vector);
+        int tracked = this->boid_cells.size();
+        this->moved = arena->take<int>(std::max(tracked, count));
+        this->moved_to = arena->take<int>(std::max(tracked, count));
+        this->moved_count = 0;
+        for (int i = 0; i < std::min(tracked, count); i += 1) {
+            int cell = this->boid_key(&boids[i]);
+            if (cell != this->boid_cells[i]) {
+                this->move(i, cell);
+            }
+        }
+        this->migrated = this->moved_count;
+
+        // boids dropped off the end of the flock only leave, new ones only arrive
+        for (int i = count; i < tracked; i += 1) {
+            this->move(i, -1);
+        }
+        for (int i = tracked; i < count; i += 1) {
+            this->move(i, this->boid_key(&boids[i]));
+        }
+        if (this->moved_count == 0) {
+            return;
+        }
+        this->boid_cells.resize(std::max(tracked, count));
+        this->boid_slots.resize(std::max(tracked, count));
+
+        for (int m = 0; m < this->moved_count; m += 1) {
+            int boid = this->moved[m];
+            if (boid >= tracked) {
+                continue;
+            }
+            int cell = this->boid_cells[boid];
+            int start = this->cell_start[cell];
+            int last = this->indices[start + this->cell_count[cell] - 1];
+            this->indices[start + this->boid_slots[boid]] = last;
+            this->boid_slots[last] = this->boid_slots[boid];
+            this->cell_count[cell] -= 1;
+        }
+
+        // `cell_arrivals` is all zero between updates, arrivals count themselves in and back out below
+        for (int m = 0; m < this->moved_count; m += 1) {
+            int cell = this->moved_to[m];
+            if (cell >= 0) {
+                this->cell_arrivals[cell] += 1;
+            }
+        }
+
+        // one pass over the cells lays out the new starts and copies each cell's survivors, leaving room for arrivals
+        this->next_start.resize(this->cell_start.size());
+        this->next_indices.resize(count);
+        int running = 0;
+        for (int cell = 0; cell <= this->cell_total(); cell += 1) {
+            int from = this->cell_start[cell];
+            int survivors = this->cell_count[cell];
+            this->next_start[cell] = running;
+            for (int k = 0; k < survivors; k += 1) {
+                this->next_indices[running + k] = this->indices[from + k];
+            }
+            running += survivors + this->cell_arrivals[cell];
+        }
+        this->next_start[this->cell_total() + 1] = running;
+
+        for (int m = 0; m < this->moved_count; m += 1) {
+            int boid = this->moved[m];
+            int cell = this->moved_to[m];
+            if (cell < 0) {
+                continue;
+            }
+            int slot = this->cell_count[cell];
+            this->next_indices[this->next_start[cell] + slot] = boid;
+            this->boid_slots[boid] = slot;
+            this->boid_cells[boid] = cell;
+            this->cell_count[cell] += 1;
+            this->cell_arrivals[cell] -= 1;
+        }
+
+        this->indices.swap(this->next_indices);
+        this->cell_start.swap(this->next_start);
+        this->boid_cells.resize(count);
+        this->boid_slots.resize(count);
     }
 
-    void alignment(VectorData *pointer, Vec2 *force, int *counter, BoidParams *params, const Boid *other) {
-        if (pointer->length > params->neighbor_distance) {
+    void move(int boid, int cell) {
+        this->moved[this->moved_count] = boid;
+        this->moved_to[this->moved_count] = cell;
+        this->moved_count += 1;
+    }
+
+    // boids were permuted with `order[new] = old` and `remap[old] = new`; only the incremental layout outlives a step
+    void remap(const std::vector<int> &order, const std::vector<int> &remap) {
+        if (!this->tracking) {
+            return;
+        }
+        // the flock was resized since the last update, the next update starts over instead
+        if (order.size() != this->boid_cells.size()) {
+            this->tracking = false;
             return;
         }
+        for (int &index : this->indices) {
+            index = remap[index];
+        }
+        int count = order.size();
+        this->next_indices.resize(count);
+        for (int k = 0; k < count; k += 1) {
+            this->next_indices[k] = this->boid_cells[order[k]];
+        }
+        this->boid_cells.swap(this->next_indices);
+        for (int k = 0; k < count; k += 1) {
+            this->next_indices[k] = this->boid_slots[order[k]];
+        }
+        this->boid_slots.swap(this->next_indices);
+    }
 
-        *counter += 1;
-        force->add_assign(other->velocity);
+    // boids that changed cell on the last incremental update, over the whole flock
+    float migrated_fraction() const {
+        return this->boid_cells.empty() ? 0 : (float)this->migrated / this->boid_cells.size();
     }
 
-    void separation(VectorData *pointer, Vec2 *force, BoidParams *params) {
-        if (pointer->length > params->separation_distance || pointer->length < 1e-4) {
+    // `visit(index, shift)`: boid `index` sits at its position plus `shift` as seen from `position`, which is only
+    // nonzero for cells across a wrapped edge
+    template <typename Visitor> void for_each_neighbor(const Vec2 *position, Visitor visit) const {
+        if (!std::isfinite(position->x) || !std::isfinite(position->y)) {
             return;
         }
+        const StencilSpan *columns = &this->columns[this->cell_x(position->x) * 2];
+        const StencilSpan *rows = &this->rows[this->cell_y(position->y) * 2];
+        for (int column = 0; column < 2; column += 1) {
+            for (int x = columns[column].first; x <= columns[column].last; x += 1) {
+                for (int row = 0; row < 2; row += 1) {
+                    Vec2 shift = Vec2::build(columns[column].shift, rows[row].shift);
+                    for (int y = rows[row].first; y <= rows[row].last; y += 1) {
+                        int cell = this->key(x, y);
+                        int begin = this->cell_start[cell];
+                        int end = begin + this->cell_count[cell];
+                        for (int k = begin; k < end; k += 1) {
+                            visit(this->indices[k], shift);
+                        }
+                    }
+                }
+            }
+        }
+    }
 
-        Vec2 repulsion = pointer->vector;
-        float inv = -1 / (pointer->length * pointer->length);
-        repulsion.mul_assign(inv);
+    int cell_x(float x) const {
+        int cell = (x - this->xmin) / this->cell_width;
+        return std::clamp(cell, 0, this->width - 1);
+    }
 
-        force->add_assign(repulsion);
+    int cell_y(float y) const {
+        int cell = (y - this->ymin) / this->cell_height;
+        return std::clamp(cell, 0, this->height - 1);
     }
-} Boid;
 
-typedef struct SpatialPartition {
-    std::unordered_map<int, std::vector<Boid *>> map;
-    float cell_size;
-    int width;
-    int height;
+    // boids with a non-finite position are parked in a trailing cell that no stencil visits
+    int boid_key(const Boid *boid) const {
+        if (!std::isfinite(boid->position.x) || !std::isfinite(boid->position.y)) {
+            return this->cell_total();
+        }
+        return this->key(this->cell_x(boid->position.x), this->cell_y(boid->position.y));
+    }
+
+    // an offset between boids seen through the stencil, taken to its nearest image along a folded axis
+    Vec2 nearest_image(Vec2 relative) const {
+        if (this->fold_x) {
+            relative.x = nearest_offset(relative.x, this->length_x);
+        }
+        if (this->fold_y) {
+            relative.y = nearest_offset(relative.y, this->length_y);
+        }
+        return relative;
+    }
+
+    int key(int x, int y) const {
+        return y * this->width + x;
+    }
+
+    // the half stencil sums a pair into the buffer of the cell it was visited from. Cells share a buffer only when
+    // at least three columns or two rows apart, so each boid's sums in a buffer come from one cell, in that cell's
+    // order, however the cells are split between workers; on a torus the columns and rows left over at the edge,
+    // which would meet their class across it, get buffers of their own
+    int pair_class(int cell) const {
+        int x = cell % this->width;
+        int y = cell / this->width;
+        int columns = this->width - (this->wrap ? this->width % 3 : 0);
+        int rows = this->height - (this->wrap ? this->height % 2 : 0);
+        int column = x < columns ? x % 3 : 3 + x - columns;
+        int row = y < rows ? y % 2 : 2;
+        return row * this->pair_columns() + column;
+    }
 
-    static SpatialPartition build(float cell_size, BoundingBox *bounds) {
-        return SpatialPartition{
-            .cell_size = cell_size,
-            .width = (int)(bounds->height() / cell_size + 1),
-            .height = (int)(bounds->width() / cell_size + 1),
+    int pair_columns() const {
+        return 3 + (this->wrap ? this->width % 3 : 0);
+    }
+
+    int pair_classes() const {
+        return this->pair_columns() * (this->wrap && this->height % 2 == 1 ? 3 : 2);
+    }
+
+    // first cell whose boids start at or after sorted slot k
+    int cell_at(int k) const {
+        return std::lower_bound(this->cell_start.begin(), this->cell_start.begin() + this->cell_total(), k) -
+               this->cell_start.begin();
+    }
+
+    int cell_total() const {
+        return this->width * this->height;
+    }
+
+    // how many boids share the cell of the boid `share` of the way through the binned flock, taken in order of how
+    // full their cells are; `counts` is scratch
+    int occupancy(float share, std::vector<int> *counts) const {
+        counts->clear();
+        counts->reserve(this->cell_total());
+        for (int cell = 0; cell < this->cell_total(); cell += 1) {
+            if (this->cell_count[cell] > 0) {
+                counts->push_back(this->cell_count[cell]);
+            }
+        }
+        std::sort(counts->begin(), counts->end());
+        long long binned = this->cell_start[this->cell_total()];
+        long long passed = 0;
+        for (int count : *counts) {
+            passed += count;
+            if (passed >= share * binned) {
+                return count;
+            }
+        }
+        return 0;
+    }
+} SpatialPartition;
+
+typedef enum Kernel {
+    KERNEL_REFERENCE,
+    KERNEL_SOA,
+    KERNEL_SIMD,
+} Kernel;
+
+typedef enum Schedule {
+    SCHEDULE_TILES,
+    SCHEDULE_STATIC,
+} Schedule;
+
+typedef enum GridUpdate {
+    GRID_REBUILD,
+    GRID_INCREMENTAL,
+} GridUpdate;
+
+typedef enum NeighborMode {
+    NEIGHBORS_GRID,
+    NEIGHBORS_VERLET,
+    NEIGHBORS_TREE,
+    NEIGHBORS_AUTO,
+} NeighborMode;
+
+// a fused step integrates each boid as soon as its force is known, reading the snapshot the grid kernels gather
+// instead of the boids they write; other kernels and neighbor backends always take two passes
+typedef enum Integration {
+    INTEGRATION_SEPARATE,
+    INTEGRATION_FUSED,
+} Integration;
+
+// a half stencil visits each pair of boids once, from the cell below or left of the other, and hands both sides
+// their share; other kernels and neighbor backends always visit a pair from either boid
+typedef enum Stencil {
+    STENCIL_FULL,
+    STENCIL_HALF,
+} Stencil;
+
+typedef enum Boundary {
+    BOUNDARY_WALLS,
+    BOUNDARY_TORUS,
+} Boundary;
+
+typedef struct EngineParams {
+    Kernel kernel;
+    int threads;
+    Schedule schedule;
+    GridUpdate grid;
+    NeighborMode neighbors;
+    float skin;
+    int reorder_interval;
+    Boundary boundary;
+    // tree only: 0 is exact, above it far nodes narrower than this times their distance stand in for their boids
+    float opening_angle;
+    // ISA_AUTO runs the hot loops with the variant picked at startup
+    Isa isa;
+    Integration integration;
+    Stencil stencil;
+} EngineParams;
+
+// what the per-pair loops do, fixed at compile time: a rule with zero weight is left out, a cone of PI or more sees
+// all round so its test goes, and a torus takes the nearest image of every offset
+template <bool Cohesion, bool Alignment, bool Separation, bool Cone, bool Wrap> struct Steering {
+    static constexpr bool cohesion = Cohesion;
+    static constexpr bool alignment = Alignment;
+    static constexpr bool separation = Separation;
+    static constexpr bool cone = Cone;
+    static constexpr bool wrap = Wrap;
+
+    static Vec2 offset(const BoundingBox *bounds, const Vec2 *from, const Vec2 *to) {
+        if constexpr (Wrap) {
+            return bounds->box_wrapped_postion(from, to);
+        } else {
+            return to->sub(*from);
+        }
+    }
+};
+
+template <bool... Flags, typename Function> void bind_steering(Function &function) {
+    function.template operator()<Steering<Flags...>>();
+}
+
+template <bool... Flags, typename Function, typename... Rest>
+void bind_steering(Function &function, bool flag, Rest... rest) {
+    if (flag) {
+        bind_steering<Flags..., true>(function, rest...);
+    } else {
+        bind_steering<Flags..., false>(function, rest...);
+    }
+}
+
+// calls `function.template operator()<Rules>()` with the Steering the params and boundary ask for
+template <typename Function> void dispatch_steering(const BoidParams *params, Boundary boundary, Function function) {
+    bind_steering(function, params->cohesion != 0, params->alignment != 0, params->separation != 0,
+                  params->peripheral_angle < PI, boundary == BOUNDARY_TORUS);
+}
+
+// every boid's candidates within `reach + skin`, reused across steps until some boid has moved more than half the
+// skin since the build: only then can a pair that is now within `reach` be missing from the lists
+typedef struct NeighborLists {
+    std::vector<int> start;
+    std::vector<int> neighbors;
+    std::vector<Vec2> anchors;
+    BoundingBox bounds;
+    float reach;
+    float skin;
+    bool wrap;
+    long long steps;
+    long long rebuilds;
+
+    // on a torus the lists depend on where the edges are, and a boid that wrapped has only moved its step
+    bool valid(const std::vector<Boid> &boids, const BoundingBox *bounds, float reach, float skin, bool wrap) const {
+        if (boids.size() != this->anchors.size() || reach != this->reach || skin != this->skin || wrap != this->wrap) {
+            return false;
+        }
+        if (wrap && (bounds->xmin != this->bounds.xmin || bounds->xmax != this->bounds.xmax ||
+                     bounds->ymin != this->bounds.ymin || bounds->ymax != this->bounds.ymax)) {
+            return false;
+        }
+        float limit = skin * skin / 4;
+        for (int i = 0; i < (int)boids.size(); i += 1) {
+            const Vec2 &now = boids[i].position;
+            const Vec2 &then = this->anchors[i];
+            bool finite = std::isfinite(now.x) && std::isfinite(now.y);
+            // a boid that went non-finite has to leave everyone's list, just like the grid parks it out of reach
+            if (finite != (std::isfinite(then.x) && std::isfinite(then.y))) {
+                return false;
+            }
+            Vec2 displacement = wrap ? bounds->box_wrapped_postion(&then, &now) : now.sub(then);
+            if (finite && displacement.length_squared() > limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // two passes over the stencil, counting then filling, so every boid's list can be written in parallel
+    void build(const std::vector<Boid> &boids, const SpatialPartition *grid, const BoundingBox *bounds, float reach,
+               float skin, ThreadPool *pool) {
+        int count = boids.size();
+        float limit = (reach + skin) * (reach + skin);
+        this->bounds = *bounds;
+        this->reach = reach;
+        this->skin = skin;
+        this->wrap = grid->wrap;
+        this->rebuilds += 1;
+        this->start.resize(count + 1);
+        this->anchors.resize(count);
+
+        auto within = [&](int i, auto visit) {
+            const Vec2 &position = boids[i].position;
+            grid->for_each_neighbor(&position, [&](int index, const Vec2 &shift) {
+                Vec2 relative = grid->nearest_image(boids[index].position.add(shift).sub(position));
+                if (index != i && relative.length_squared() <= limit) {
+                    visit(index);
+                }
+            });
+        };
+
+        pool->parallel_for(count, [&](int begin, int end) {
+            for (int i = begin; i < end; i += 1) {
+                int found = 0;
+                within(i, [&](int) { found += 1; });
+                this->start[i + 1] = found;
+                this->anchors[i] = boids[i].position;
+            }
+        });
+        this->start[0] = 0;
+        for (int i = 0; i < count; i += 1) {
+            this->start[i + 1] += this->start[i];
+        }
+        this->neighbors.resize(this->start[count]);
+        pool->parallel_for(count, [&](int begin, int end) {
+            for (int i = begin; i < end; i += 1) {
+                int next = this->start[i];
+                within(i, [&](int index) {
+                    this->neighbors[next] = index;
+                    next += 1;
+                });
+            }
+        });
+    }
+
+    float rebuild_interval() const {
+        return this->rebuilds > 0 ? (float)this->steps / this->rebuilds : 0;
+    }
+
+    float candidates_per_boid() const {
+        return this->anchors.empty() ? 0 : (float)this->neighbors.size() / this->anchors.size();
+    }
+} NeighborLists;
+
+#define TREE_LEAF_SIZE 16
+// deep enough for any tree that median splits can build out of an int count of boids
+#define TREE_STACK 64
+// neighbor_distance over separation_distance from which NEIGHBORS_AUTO picks the tree over the grid
+#define TREE_RADIUS_RATIO 16
+
+// the tight box around a node's boids and their sums, so a query can take a node that lies wholly inside its radius
+// and view cone without looking at the boids in it
+typedef struct TreeNode {
+    float xmin;
+    float xmax;
+    float ymin;
+    float ymax;
+    Vec2 position_sum;
+    Vec2 velocity_sum;
+    int begin;
+    int end;
+    int children;
+} TreeNode;
+
+typedef struct FlockSums {
+    Vec2 cohesion;
+    Vec2 alignment;
+    Vec2 separation;
+    int count;
+} FlockSums;
+
+// the boid asking: `center` is its position moved against the image shift on a torus, `cone` the cosine limit of
+// accumulate_cell, and `edges` the inward normals of the two sides of a cone no wider than a half plane
+typedef struct TreeQuery {
+    Vec2 center;
+    Vec2 heading;
+    float speed;
+    float cone;
+    Vec2 edges[2];
+    int self;
+    // half the length of each axis too short for two reaches on a torus, infinite otherwise: a boid counts only in
+    // the image whose offset lies within it, its nearest
+    Vec2 window;
+
+    static TreeQuery build(const Boid *target, float cone, int self) {
+        Vec2 heading = target->velocity;
+        Vec2 side = Vec2::build(-heading.y, heading.x);
+        float sine = sqrt(fmax(1 - cone * cone, 0));
+        return TreeQuery{
+            .center = target->position,
+            .heading = heading,
+            .speed = heading.length(),
+            .cone = cone,
+            .edges = {heading.mul(sine).sub(side.mul(cone)), heading.mul(sine).add(side.mul(cone))},
+            .self = self,
+            .window = Vec2::build(INFINITY, INFINITY),
         };
     }
 
-    void insert(Boid *boid) {
-        this->map[this->boid_key(boid)].push_back(boid);
+    // the half-open window (-window, window] on each axis, so a boid exactly half way round counts once
+    bool in_window(const Vec2 &relative) const {
+        return relative.x > -this->window.x && relative.x <= this->window.x && relative.y > -this->window.y &&
+               relative.y <= this->window.y;
+    }
+
+    bool window_holds(const TreeNode *node) const {
+        return this->in_window(Vec2::build(node->xmin - this->center.x, node->ymin - this->center.y)) &&
+               this->in_window(Vec2::build(node->xmax - this->center.x, node->ymax - this->center.y));
+    }
+
+    bool window_misses(const TreeNode *node) const {
+        return node->xmax - this->center.x <= -this->window.x || node->xmin - this->center.x > this->window.x ||
+               node->ymax - this->center.y <= -this->window.y || node->ymin - this->center.y > this->window.y;
+    }
+
+    // same acceptance as the simd kernel, nan ratios included
+    bool visible(const Vec2 &relative, float distance_squared) const {
+        float ratio = this->heading.x * relative.x + this->heading.y * relative.y;
+        ratio /= this->speed * sqrt(distance_squared);
+        return !(ratio >= -1 && ratio < this->cone);
+    }
+
+    // whether a corner lies strictly inside the cone, leaving out the edge cases `visible` lets through
+    bool sees_corner(float x, float y) const {
+        return this->heading.x * x + this->heading.y * y >= this->cone * this->speed * sqrt(x * x + y * y);
+    }
+
+    // both the visible cone and, for wider angles, the hidden one are convex, so a box is on one side when all four
+    // corners are
+    bool sees_box(const TreeNode *node) const {
+        if (this->cone < -1) {
+            return true;
+        }
+        if (this->cone < 0) {
+            return false;
+        }
+        float xs[2] = {node->xmin - this->center.x, node->xmax - this->center.x};
+        float ys[2] = {node->ymin - this->center.y, node->ymax - this->center.y};
+        for (float x : xs) {
+            for (float y : ys) {
+                if (!this->sees_corner(x, y)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // a boid within rounding of straight behind, let through elsewhere on a nan ratio, is pruned with the rest
+    bool hides_box(const TreeNode *node) const {
+        if (this->cone < -1 || this->speed == 0) {
+            return false;
+        }
+        float xs[2] = {node->xmin - this->center.x, node->xmax - this->center.x};
+        float ys[2] = {node->ymin - this->center.y, node->ymax - this->center.y};
+        if (this->cone < 0) {
+            for (float x : xs) {
+                for (float y : ys) {
+                    if (this->sees_corner(x, y) || !(this->heading.x * x + this->heading.y * y < 0)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        for (const Vec2 &edge : this->edges) {
+            bool outside = true;
+            for (float x : xs) {
+                for (float y : ys) {
+                    outside = outside && edge.x * x + edge.y * y < 0;
+                }
+            }
+            if (outside) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float nearest_squared(const TreeNode *node) const {
+        float x = std::max({node->xmin - this->center.x, this->center.x - node->xmax, 0.0f});
+        float y = std::max({node->ymin - this->center.y, this->center.y - node->ymax, 0.0f});
+        return x * x + y * y;
     }
 
-    std::vector<Boid *> get_neighbors(Boid *target) {
-        std::vector<Boid *> neighbors;
-        int basex = target->position.x / this->cell_size;
-        int basey = target->position.y / this->cell_size;
-        for (int dx = -1; dx <= 1; dx += 1) {
-            for (int dy = -1; dy <= 1; dy += 1) {
-                int key = this->key(basex + dx, basey + dy);
-                if (this->map.count(key) == 0) {
+    float farthest_squared(const TreeNode *node) const {
+        float x = std::max(this->center.x - node->xmin, node->xmax - this->center.x);
+        float y = std::max(this->center.y - node->ymin, node->ymax - this->center.y);
+        return x * x + y * y;
+    }
+} TreeQuery;
+
+typedef struct TreePoint {
+    Vec2 position;
+    Vec2 velocity;
+    int index;
+} TreePoint;
+
+// k-d tree over copies of the finite boids, split at the median of the longer side, so a leaf is one contiguous read
+typedef struct BoidTree {
+    std::vector<TreeNode> nodes;
+    std::vector<TreePoint> points;
+
+    void build(const std::vector<Boid> &boids) {
+        this->points.clear();
+        for (int i = 0; i < (int)boids.size(); i += 1) {
+            if (std::isfinite(boids[i].position.x) && std::isfinite(boids[i].position.y)) {
+                this->points.push_back(TreePoint{.position = boids[i].position, .velocity = boids[i].velocity, .index = i});
+            }
+        }
+        this->nodes.clear();
+        if (this->points.empty()) {
+            return;
+        }
+        this->nodes.push_back(TreeNode{.begin = 0, .end = (int)this->points.size()});
+        this->split(0);
+    }
+
+    // nodes may move while children are appended, so this works through indices only
+    void split(int index) {
+        int begin = this->nodes[index].begin;
+        int end = this->nodes[index].end;
+        TreeNode node = TreeNode{
+            .xmin = INFINITY,
+            .xmax = -INFINITY,
+            .ymin = INFINITY,
+            .ymax = -INFINITY,
+            .position_sum = Vec2::zeros(),
+            .velocity_sum = Vec2::zeros(),
+            .begin = begin,
+            .end = end,
+            .children = -1,
+        };
+        for (int k = begin; k < end; k += 1) {
+            const TreePoint &point = this->points[k];
+            node.xmin = std::min(node.xmin, point.position.x);
+            node.xmax = std::max(node.xmax, point.position.x);
+            node.ymin = std::min(node.ymin, point.position.y);
+            node.ymax = std::max(node.ymax, point.position.y);
+            node.position_sum.add_assign(point.position);
+            node.velocity_sum.add_assign(point.velocity);
+        }
+
+        // boids stacked on one point stay in one leaf, whatever their number
+        bool vertical = node.xmax - node.xmin >= node.ymax - node.ymin;
+        if (end - begin <= TREE_LEAF_SIZE || (node.xmax == node.xmin && node.ymax == node.ymin)) {
+            this->nodes[index] = node;
+            return;
+        }
+        int middle = (begin + end) / 2;
+        std::nth_element(this->points.begin() + begin, this->points.begin() + middle, this->points.begin() + end,
+                         [&](const TreePoint &a, const TreePoint &b) {
+                             return vertical ? a.position.x < b.position.x : a.position.y < b.position.y;
+                         });
+        node.children = this->nodes.size();
+        this->nodes[index] = node;
+        this->nodes.push_back(TreeNode{.begin = begin, .end = middle});
+        this->nodes.push_back(TreeNode{.begin = middle, .end = end});
+        this->split(node.children);
+        this->split(node.children + 1);
+    }
+
+    // cohesion and alignment over every visible boid within `radius`; nodes wholly in reach and in view are taken
+    // from their sums and nodes out of view are skipped, so the work grows with the rim of the visible sector.
+    // With an `opening` angle, Barnes-Hut style, a node that looks small from the query is taken or dropped whole
+    // by where its center of mass falls, which bounds the work by the depth of the tree
+    void gather(const TreeQuery *query, float radius, float opening, FlockSums *sums) const {
+        if (this->nodes.empty()) {
+            return;
+        }
+        float limit = radius * radius;
+        int stack[TREE_STACK];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const TreeNode *node = &this->nodes[stack[--top]];
+            float nearest = query->nearest_squared(node);
+            if (nearest > limit || query->hides_box(node) || query->window_misses(node)) {
+                continue;
+            }
+            // a box holding the center may hold the asking boid itself, only leaves can leave it out; a box across
+            // the window's edge has to be opened too
+            bool whole = query->window_holds(node);
+            if (nearest > 0 && whole && query->farthest_squared(node) <= limit && query->sees_box(node)) {
+                int count = node->end - node->begin;
+                sums->cohesion.add_assign(node->position_sum.sub(query->center.mul(count)));
+                sums->alignment.add_assign(node->velocity_sum);
+                sums->count += count;
+                continue;
+            }
+            if (opening > 0 && nearest > 0 && whole && node->children >= 0) {
+                int count = node->end - node->begin;
+                Vec2 relative = node->position_sum.div(count).sub(query->center);
+                float distance_squared = relative.length_squared();
+                float size = std::max(node->xmax - node->xmin, node->ymax - node->ymin);
+                if (size * size < opening * opening * distance_squared) {
+                    if (distance_squared <= limit && query->visible(relative, distance_squared)) {
+                        sums->cohesion.add_assign(relative.mul(count));
+                        sums->alignment.add_assign(node->velocity_sum);
+                        sums->count += count;
+                    }
                     continue;
                 }
-                for (Boid *boid_ptr : this->map.at(key)) {
-                    neighbors.push_back(boid_ptr);
+            }
+            if (node->children >= 0) {
+                stack[top++] = node->children;
+                stack[top++] = node->children + 1;
+                continue;
+            }
+            for (int k = node->begin; k < node->end; k += 1) {
+                const TreePoint &point = this->points[k];
+                Vec2 relative = point.position.sub(query->center);
+                float distance_squared = relative.length_squared();
+                if (point.index == query->self || distance_squared > limit || !query->in_window(relative) ||
+                    !query->visible(relative, distance_squared)) {
+                    continue;
                 }
+                sums->cohesion.add_assign(relative);
+                sums->alignment.add_assign(point.velocity);
+                sums->count += 1;
             }
         }
+    }
 
-        return neighbors;
+    // separation only ever looks at single boids, but prunes at its own, usually much smaller, radius
+    void separate(const TreeQuery *query, float radius, FlockSums *sums) const {
+        if (this->nodes.empty()) {
+            return;
+        }
+        float limit = radius * radius;
+        int stack[TREE_STACK];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const TreeNode *node = &this->nodes[stack[--top]];
+            if (query->nearest_squared(node) > limit || query->hides_box(node) || query->window_misses(node)) {
+                continue;
+            }
+            if (node->children >= 0) {
+                stack[top++] = node->children;
+                stack[top++] = node->children + 1;
+                continue;
+            }
+            for (int k = node->begin; k < node->end; k += 1) {
+                const TreePoint &point = this->points[k];
+                Vec2 relative = point.position.sub(query->center);
+                float distance_squared = relative.length_squared();
+                if (point.index == query->self || distance_squared > limit || distance_squared < 1e-8 ||
+                    !query->in_window(relative) || !query->visible(relative, distance_squared)) {
+                    continue;
+                }
+                sums->separation.add_assign(relative.mul(-1 / distance_squared));
+            }
+        }
     }
+} BoidTree;
 
-    int boid_key(Boid *boid) {
-        return this->key(boid->position.x / this->cell_size, boid->position.y / this->cell_size);
+// the image shifts a query at `coordinate` needs on a wrapped axis, zero first. An axis too short to hold two
+// reaches may see a boid in reach twice, so it queries both neighboring images and leaves `window` at half its
+// length to keep the nearest one, the image every other backend takes
+static int image_shifts(float coordinate, float low, float high, float reach, bool wrap, float shifts[3],
+                        float *window) {
+    shifts[0] = 0;
+    *window = INFINITY;
+    float length = high - low;
+    if (!wrap) {
+        return 1;
+    }
+    if (length < 2 * reach) {
+        shifts[1] = length;
+        shifts[2] = -length;
+        *window = length / 2;
+        return 3;
     }
+    if (coordinate + reach > high) {
+        shifts[1] = length;
+        return 2;
+    }
+    if (coordinate - reach < low) {
+        shifts[1] = -length;
+        return 2;
+    }
+    return 1;
+}
+
+#define NEAREST_LIMIT 32
+// a capped flock's grid cells hold about this many times the cap where the boids are: the grid is refit once the
+// cell of the boid NEAREST_OCCUPANCY of the way through the flock, by how full their cells are, is off from that by
+// more than NEAREST_REFIT either way. Cells stay at least NEAREST_MIN_CELL of the reach, and the grid at most
+// NEAREST_CELLS_PER_BOID cells per boid however small a part of the bounds the flock fills
+#define NEAREST_CELL_FILL 2
+#define NEAREST_OCCUPANCY 0.5f
+#define NEAREST_REFIT 1.5f
+#define NEAREST_MIN_CELL (1.0f / 16)
+#define NEAREST_CELLS_PER_BOID 4
+// relative widening of the cell borders in the nearest search, far above float rounding
+#define NEAREST_SLACK 1e-4f
 
-    int key(int x, int y) {
-        return y * this->height + x;
+// a visible boid in reach, with what steering needs of it
+typedef struct NearestCandidate {
+    float distance_squared;
+    int index;
+    Vec2 relative;
+    Vec2 velocity;
+} NearestCandidate;
+
+// nearer, or as near and lower in index, so every path picks the same boids at equal distances
+static bool nearer(const NearestCandidate &a, const NearestCandidate &b) {
+    return a.distance_squared < b.distance_squared || (a.distance_squared == b.distance_squared && a.index < b.index);
+}
+
+// the `limit` nearest candidates offered so far, as a max-heap with the farthest on top: a candidate past it is
+// turned away on one compare, a nearer one replaces it in log(limit) steps
+typedef struct NearestHeap {
+    NearestCandidate items[NEAREST_LIMIT];
+    int count;
+    int limit;
+    float reach_squared;
+
+    static NearestHeap build(int limit, float reach_squared) {
+        NearestHeap heap;
+        heap.count = 0;
+        heap.limit = std::min(limit, NEAREST_LIMIT);
+        heap.reach_squared = reach_squared;
+        return heap;
     }
 
-} SpatialPartition;
+    // the squared distance a candidate may still have, for filtering before `offer`
+    float bound() const {
+        return this->count < this->limit ? this->reach_squared : this->items[0].distance_squared;
+    }
+
+    void offer(const NearestCandidate &candidate) {
+        if (candidate.distance_squared > this->reach_squared) {
+            return;
+        }
+        if (this->count < this->limit) {
+            int slot = this->count;
+            this->count += 1;
+            while (slot > 0 && nearer(this->items[(slot - 1) / 2], candidate)) {
+                this->items[slot] = this->items[(slot - 1) / 2];
+                slot = (slot - 1) / 2;
+            }
+            this->items[slot] = candidate;
+            return;
+        }
+        if (nearer(candidate, this->items[0])) {
+            this->sift_down(candidate, this->count);
+        }
+    }
+
+    // puts `candidate` in place of the top of the first `count` items
+    void sift_down(const NearestCandidate &candidate, int count) {
+        int slot = 0;
+        while (2 * slot + 1 < count) {
+            int child = 2 * slot + 1;
+            if (child + 1 < count && nearer(this->items[child], this->items[child + 1])) {
+                child += 1;
+            }
+            if (!nearer(candidate, this->items[child])) {
+                break;
+            }
+            this->items[slot] = this->items[child];
+            slot = child;
+        }
+        this->items[slot] = candidate;
+    }
+
+    // nearest first, so every path sums the chosen boids in the same order
+    void sort() {
+        for (int last = this->count - 1; last > 0; last -= 1) {
+            NearestCandidate farthest = this->items[0];
+            this->sift_down(this->items[last], last);
+            this->items[last] = farthest;
+        }
+    }
+} NearestHeap;
+
+// loads in the simd kernel may run up to one full register past the last boid
+#define BOID_ARRAY_PADDING 16
+
+typedef struct BoidArrays {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> ax;
+    std::vector<float> ay;
+    // |velocity|, for the half stencil's cone test from the far end of a pair
+    std::vector<float> speed;
+    int count;
+
+    void resize(int count) {
+        this->count = count;
+        int padded = count + BOID_ARRAY_PADDING;
+        for (std::vector<float> *array : {&this->x, &this->y, &this->vx, &this->vy, &this->ax, &this->ay,
+                                          &this->speed}) {
+            array->resize(padded);
+            std::fill(array->begin() + count, array->end(), 0);
+        }
+    }
+
+    // copies the boids into grid order, so every stencil row is one contiguous slice of the arrays
+    void gather(const std::vector<Boid> &boids, const SpatialPartition *grid, int begin, int end) {
+        for (int k = begin; k < end; k += 1) {
+            const Boid &boid = boids[grid->indices[k]];
+            this->x[k] = boid.position.x;
+            this->y[k] = boid.position.y;
+            this->vx[k] = boid.velocity.x;
+            this->vy[k] = boid.velocity.y;
+            this->speed[k] = sqrt(boid.velocity.length_squared());
+            this->ax[k] = 0;
+            this->ay[k] = 0;
+        }
+    }
+
+    void scatter_forces(std::vector<Vec2> &accelerations, const SpatialPartition *grid, int begin, int end) {
+        for (int k = begin; k < end; k += 1) {
+            accelerations[grid->indices[k]].add_assign(Vec2::build(this->ax[k], this->ay[k]));
+        }
+    }
+} BoidArrays;
+
+// one worker's half of the sums a half-stencil pass gives each boid, in the grid order of BoidArrays. Both boids
+// of a pair add into the buffer of the worker that visited the pair, and the pass that adds up the workers zeroes
+// what it read, so the buffers start every step at zero without being cleared
+typedef struct PairSums {
+    std::vector<float> cohesion_x;
+    std::vector<float> cohesion_y;
+    std::vector<float> alignment_x;
+    std::vector<float> alignment_y;
+    std::vector<float> separation_x;
+    std::vector<float> separation_y;
+    std::vector<float> neighbors;
+
+    void resize(int count) {
+        for (std::vector<float> *array : {&this->cohesion_x, &this->cohesion_y, &this->alignment_x, &this->alignment_y,
+                                          &this->separation_x, &this->separation_y, &this->neighbors}) {
+            array->resize(count + BOID_ARRAY_PADDING);
+        }
+    }
+
+    // adds boid k's sums into the totals and zeroes them
+    void take(int k, Vec2 *cohesion, Vec2 *alignment, Vec2 *separation, float *neighbors) {
+        cohesion->add_assign(Vec2::build(this->cohesion_x[k], this->cohesion_y[k]));
+        alignment->add_assign(Vec2::build(this->alignment_x[k], this->alignment_y[k]));
+        separation->add_assign(Vec2::build(this->separation_x[k], this->separation_y[k]));
+        *neighbors += this->neighbors[k];
+        this->cohesion_x[k] = 0;
+        this->cohesion_y[k] = 0;
+        this->alignment_x[k] = 0;
+        this->alignment_y[k] = 0;
+        this->separation_x[k] = 0;
+        this->separation_y[k] = 0;
+        this->neighbors[k] = 0;
+    }
+} PairSums;
+
+// where a fused step writes each boid once integrated; the kernels read only the gathered arrays, so the boids
+// they overwrite are never read in the same pass
+typedef struct FusedStep {
+    Boid *boids;
+    BoundingBox *bounds;
+    const BoidParams *params;
+    float delta_time;
+} FusedStep;
+
+// kernels.hpp once per instruction set; dispatch_kernels runs the one for an Isa
+namespace kernels_baseline {
+#define BOIDS_LANES LanesNative
+#include "kernels.hpp"
+#undef BOIDS_LANES
+} // namespace kernels_baseline
+
+#if defined(BOIDS_ISA_VARIANTS)
+BOIDS_TARGET_BEGIN(BOIDS_TARGET_AVX2)
+namespace kernels_avx2 {
+#define BOIDS_LANES LanesAVX2
+#include "kernels.hpp"
+#undef BOIDS_LANES
+} // namespace kernels_avx2
+BOIDS_TARGET_END
+
+BOIDS_TARGET_BEGIN(BOIDS_TARGET_AVX512)
+namespace kernels_avx512 {
+#define BOIDS_LANES LanesAVX512
+#include "kernels.hpp"
+#undef BOIDS_LANES
+} // namespace kernels_avx512
+BOIDS_TARGET_END
+#endif
+
+// calls `function.template operator()<K>()` with the Kernels compiled for `isa`, once resolved
+template <typename Function> void dispatch_kernels(Isa isa, Function function) {
+    switch (resolve_isa(isa)) {
+#if defined(BOIDS_ISA_VARIANTS)
+    case ISA_AVX512:
+        function.template operator()<kernels_avx512::Kernels>();
+        return;
+    case ISA_AVX2:
+        function.template operator()<kernels_avx2::Kernels>();
+        return;
+#endif
+    default:
+        function.template operator()<kernels_baseline::Kernels>();
+        return;
+    }
+}
 
 typedef struct BoidManager {
     BoidParams params;
+    EngineParams engine;
     std::vector<Boid> boids;
+    // a two-pass step's forces, from the force pass to integration, which zeroes them again
+    std::vector<Vec2> accelerations;
     SpatialPartition grid;
+    BoidArrays arrays;
+    // half stencil only: one per class of cells, see SpatialPartition::pair_class
+    std::vector<PairSums> pair_sums;
+    // nearest cap only: the cell size the last step picked, and scratch for the cell counts that refit it
+    float nearest_cell;
+    std::vector<int> occupancy;
+    TileScheduler scheduler;
+    NeighborLists lists;
+    BoidTree tree;
+    std::shared_ptr<ThreadPool> pool;
+    // scratch never outlives the pass that took it, so each pass starts from an empty arena
+    FrameArena frame;
+
+    // reordering state: `order[new] = old` and `remap[old] = new` for the step that last set `reordered`
+    RadixSort sorter;
+    std::vector<Boid> sorted_boids;
+    std::vector<int> order;
+    std::vector<int> remap;
+    long long step;
+    bool reordered;
+
+    // only the grid kernels gather a snapshot of the flock that a fused step can read while it writes the boids
+    bool fused() const {
+        return this->engine.integration == INTEGRATION_FUSED && this->engine.kernel != KERNEL_REFERENCE &&
+               this->neighbor_mode() == NEIGHBORS_GRID;
+    }
+
+    // a nearest cap on the grid kernels searches rows of cells sized to the cap rather than the reach
+    bool nearest_grid() const {
+        return this->params.nearest_neighbors > 0 && this->engine.kernel != KERNEL_REFERENCE &&
+               this->neighbor_mode() == NEIGHBORS_GRID;
+    }
 
+    // the half stencil runs in the grid kernels only, like a fused step, and without a nearest cap, which is not
+    // symmetric
+    bool half_stencil() const {
+        return this->engine.stencil == STENCIL_HALF && this->engine.kernel != KERNEL_REFERENCE &&
+               this->neighbor_mode() == NEIGHBORS_GRID && this->params.nearest_neighbors <= 0;
+    }
+
+    // NEIGHBORS_AUTO answers both radii with one grid while they are close, and switches to the tree once the
+    // cohesion radius makes grid cells so large that separation scans mostly boids it then rejects
+    NeighborMode neighbor_mode() const {
+        if (this->engine.neighbors != NEIGHBORS_AUTO) {
+            return this->engine.neighbors;
+        }
+        // the tree cannot pick out the nearest boids, so a capped flock stays on the grid
+        bool spread = this->params.neighbor_distance >= TREE_RADIUS_RATIO * this->params.separation_distance;
+        return spread && this->params.nearest_neighbors <= 0 ? NEIGHBORS_TREE : NEIGHBORS_GRID;
+    }
+
+    // with neighbor lists the grid is only rebuilt on the steps that rebuild the lists
     void populate_map(BoundingBox *bounds) {
-        float size = fmax(this->params.neighbor_distance, this->params.separation_distance);
-        this->grid = SpatialPartition::build(size, bounds);
+        PROFILE_SCOPE("BoidManager::populate_map");
+        this->frame.reset();
+        float reach = fmax(this->params.neighbor_distance, this->params.separation_distance);
+        float size = reach;
+        bool wrap = this->engine.boundary == BOUNDARY_TORUS;
+        NeighborMode mode = this->neighbor_mode();
+        if (mode == NEIGHBORS_TREE) {
+            this->tree.build(this->boids);
+            return;
+        }
+        if (mode == NEIGHBORS_VERLET) {
+            this->lists.steps += 1;
+            if (this->lists.valid(this->boids, bounds, reach, this->engine.skin, wrap)) {
+                return;
+            }
+            size = reach + this->engine.skin;
+        }
+        if (this->nearest_grid()) {
+            size = this->nearest_cell_size(bounds, reach);
+        }
 
-        for (Boid &boid : this->boids) {
-            this->grid.insert(&boid);
+        bool reset = this->grid.resize(size, bounds, wrap);
+        if (this->engine.grid == GRID_INCREMENTAL) {
+            this->grid.update(this->boids, reset, &this->frame);
+        } else {
+            int count = this->boids.size();
+            this->grid.boid_cells.resize(count);
+            dispatch_kernels(this->engine.isa, [&]<typename K>() {
+                K::bin(&this->grid, this->boids.data(), 0, count, this->grid.boid_cells.data());
+            });
+            this->grid.sort_binned();
+        }
+        if (mode == NEIGHBORS_VERLET) {
+            this->lists.build(this->boids, &this->grid, bounds, reach, this->engine.skin, this->workers());
         }
     }
 
-    void update_boids(BoundingBox *bounds, float delta_time) {
-        this->populate_map(bounds);
-        for (Boid &target : this->boids) {
+    // starts from the flock's mean density, then follows where the boids are by the last step's grid: a flock
+    // collapsed into a small part of the bounds fills cells sized for the mean far past the cap. A grid last built
+    // for another size says nothing about this one, so then the mean is all there is to go on
+    float nearest_cell_size(BoundingBox *bounds, float reach) {
+        float fill = NEAREST_CELL_FILL * std::min(this->params.nearest_neighbors, NEAREST_LIMIT);
+        float area = bounds->width() * bounds->height();
+        int count = std::max((int)this->boids.size(), 1);
+        float size = this->nearest_cell;
+        if (size <= 0 || size != this->grid.cell_size || this->grid.cell_start.empty()) {
+            size = sqrt(area * fill / count);
+        } else {
+            float occupied = this->grid.occupancy(NEAREST_OCCUPANCY, &this->occupancy);
+            if (occupied > fill * NEAREST_REFIT || occupied < fill / NEAREST_REFIT) {
+                size *= sqrt(fill / std::max(occupied, 1.0f));
+            }
+        }
+        float crowded = sqrt(area / (count * (float)NEAREST_CELLS_PER_BOID));
+        float smallest = std::max<float>(reach * NEAREST_MIN_CELL, crowded);
+        this->nearest_cell = std::clamp(size, std::min(smallest, reach), reach);
+        return this->nearest_cell;
+    }
+
+    void accumulate_forces(BoundingBox *bounds) {
+        PROFILE_SCOPE("BoidManager::forces");
+        this->frame.reset();
+        this->accelerations.resize(this->boids.size());
+        if (this->neighbor_mode() == NEIGHBORS_VERLET) {
+            dispatch_steering(&this->params, this->engine.boundary, [&]<typename Rules>() {
+                this->accumulate_forces_lists<Rules>(bounds);
+            });
+            return;
+        }
+        if (this->neighbor_mode() == NEIGHBORS_TREE) {
+            this->accumulate_forces_tree(bounds);
+            return;
+        }
+        dispatch_steering(&this->params, this->engine.boundary, [&]<typename Rules>() {
+            switch (this->engine.kernel) {
+            case KERNEL_REFERENCE:
+                this->accumulate_forces_reference<Rules>();
+                return;
+            case KERNEL_SOA:
+                this->accumulate_forces_arrays<kernels_baseline::Kernels, LanesScalar, Rules>(nullptr);
+                return;
+            case KERNEL_SIMD:
+                dispatch_kernels(this->engine.isa, [&]<typename K>() {
+                    this->accumulate_forces_arrays<K, typename K::Lanes, Rules>(nullptr);
+                });
+                return;
+            }
+        });
+    }
 
-            Vec2 cohesion_force = Vec2::zeros();
-            Vec2 alignment_force = Vec2::zeros();
-            Vec2 separation_force = Vec2::zeros();
+    // forces and integration in one pass over the grid kernels' snapshot, see `fused`
+    void step_fused(BoundingBox *bounds, float delta_time) {
+        PROFILE_SCOPE("BoidManager::step_fused");
+        this->frame.reset();
+        FusedStep fused = FusedStep{
+            .boids = this->boids.data(),
+            .bounds = bounds,
+            .params = &this->params,
+            .delta_time = delta_time,
+        };
+        dispatch_steering(&this->params, this->engine.boundary, [&]<typename Rules>() {
+            if (this->engine.kernel == KERNEL_SOA) {
+                this->accumulate_forces_arrays<kernels_baseline::Kernels, LanesScalar, Rules>(&fused);
+                return;
+            }
+            dispatch_kernels(this->engine.isa, [&]<typename K>() {
+                this->accumulate_forces_arrays<K, typename K::Lanes, Rules>(&fused);
+            });
+        });
+    }
 
-            int cohesion_count = 0;
-            int alignment_count = 0;
+    // forces read the gathered snapshot and write ax/ay only, or with `fused` each boid's own next state, so any
+    // split of the cells gives the same result. A half stencil leaves both in the PairSums of each cell's class
+    // until all pairs are in, and a pass over the boids adds them up in class order, which no split changes either;
+    // its cells are never sliced, since two slices of one cell would write the same sums
+    template <typename K, typename L, typename Rules> void accumulate_forces_arrays(const FusedStep *fused) {
+        ThreadPool *pool = this->workers();
+        int count = this->boids.size();
+        this->arrays.resize(count);
+        PairSums *half = nullptr;
+        if (this->half_stencil()) {
+            this->pair_sums.resize(this->grid.pair_classes());
+            for (PairSums &sums : this->pair_sums) {
+                sums.resize(count);
+            }
+            half = this->pair_sums.data();
+        }
 
-            for (Boid *other_ptr : this->grid.get_neighbors(&target)) {
-                Boid &other = *other_ptr;
-                if (&target == &other) {
-                    continue;
+        pool->parallel_for(count, [&](int begin, int end) {
+            this->arrays.gather(this->boids, &this->grid, begin, end);
+        });
+
+        if (this->engine.schedule == SCHEDULE_TILES) {
+            this->scheduler.plan(this->grid.cell_start.data(), this->grid.cell_count.data(), this->grid.width,
+                                 this->grid.height, pool->size(), half == nullptr, &this->frame);
+            this->scheduler.run(pool, [&](const WorkItem *item, int worker) {
+                return K::template accumulate_item<L, Rules>(&this->arrays, &this->grid, &this->params, item, half,
+                                                             fused);
+            });
+        } else {
+            int workers = pool->size();
+            this->scheduler.counters.assign(workers, WorkerCounters{});
+            auto started = std::chrono::steady_clock::now();
+            auto forces = [&](int worker) {
+                int first = this->grid.cell_at(count * (long long)worker / workers);
+                int last = this->grid.cell_at(count * (long long)(worker + 1) / workers);
+                if (worker == workers - 1) {
+                    last = this->grid.cell_total();
                 }
+                auto begin = std::chrono::steady_clock::now();
+                WorkerCounters &counters = this->scheduler.counters[worker];
+                counters.pairs = K::template accumulate_forces<L, Rules>(&this->arrays, &this->grid, &this->params,
+                                                                         first, last, half, fused);
+                counters.busy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - begin)
+                                       .count();
+                counters.items = 1;
+            };
+            pool->run(forces);
+            this->scheduler.finish(started);
+        }
 
-                Vec2 relative = other.position.sub(target.position);
-                if (target.velocity.angle(relative) > params.peripheral_angle) {
-                    continue;
+        if (half != nullptr) {
+            pool->parallel_for(this->grid.cell_start[this->grid.cell_total()], [&](int begin, int end) {
+                K::template reduce<Rules>(&this->arrays, &this->grid, &this->params, half, this->grid.pair_classes(),
+                                          begin, end, fused);
+            });
+        }
+
+        if (fused != nullptr) {
+            // boids parked off the grid get no force, but move on like any other
+            for (int k = this->grid.cell_start[this->grid.cell_total()]; k < count; k += 1) {
+                Boid *boid = &this->boids[this->grid.indices[k]];
+                K::template advance<Rules::wrap>(boid, Vec2::zeros(), fused->bounds, fused->params, fused->delta_time);
+            }
+            return;
+        }
+        pool->parallel_for(count, [&](int begin, int end) {
+            this->arrays.scatter_forces(this->accelerations, &this->grid, begin, end);
+        });
+    }
+
+    template <typename Rules> void accumulate_forces_reference() {
+        for (int i = 0; i < (int)this->boids.size(); i += 1) {
+            const Vec2 &position = this->boids[i].position;
+            this->accumulate_boid<Rules>(i, [&](auto visit) {
+                this->grid.for_each_neighbor(&position, [&](int index, const Vec2 &shift) {
+                    visit(index, this->grid.nearest_image(this->boids[index].position.add(shift).sub(position)));
+                });
+            });
+        }
+    }
+
+    // the reference math over each boid's cached list, whichever kernel the engine asks for; a boid only writes its
+    // own acceleration, so any split works.
+    // lists keep no shifts since a boid may wrap between rebuilds, the nearest image is taken per pair instead
+    template <typename Rules> void accumulate_forces_lists(BoundingBox *bounds) {
+        this->workers()->parallel_for(this->boids.size(), [&](int begin, int end) {
+            for (int i = begin; i < end; i += 1) {
+                const Vec2 &position = this->boids[i].position;
+                this->accumulate_boid<Rules>(i, [&](auto visit) {
+                    for (int k = this->lists.start[i]; k < this->lists.start[i + 1]; k += 1) {
+                        const Vec2 &other = this->boids[this->lists.neighbors[k]].position;
+                        visit(this->lists.neighbors[k], Rules::offset(bounds, &position, &other));
+                    }
+                });
+            }
+        });
+    }
+
+    // walks the boids in tree order so consecutive queries share most of their nodes; boids outside the tree have a
+    // non-finite position and get no forces, like in the grid
+    void accumulate_forces_tree(BoundingBox *bounds) {
+        bool wrap = this->engine.boundary == BOUNDARY_TORUS;
+        float reach = fmax(this->params.neighbor_distance, this->params.separation_distance);
+        float cone = this->params.peripheral_angle >= PI ? -2 : cos(this->params.peripheral_angle);
+        this->workers()->parallel_for(this->tree.points.size(), [&](int begin, int end) {
+            for (int k = begin; k < end; k += 1) {
+                int i = this->tree.points[k].index;
+                Boid &target = this->boids[i];
+                Vec2 &acceleration = this->accelerations[i];
+                TreeQuery query = TreeQuery::build(&target, cone, i);
+                FlockSums sums = FlockSums{};
+                float xs[3];
+                float ys[3];
+                int columns = image_shifts(target.position.x, bounds->xmin, bounds->xmax, reach, wrap, xs,
+                                           &query.window.x);
+                int rows = image_shifts(target.position.y, bounds->ymin, bounds->ymax, reach, wrap, ys,
+                                        &query.window.y);
+                for (int column = 0; column < columns; column += 1) {
+                    for (int row = 0; row < rows; row += 1) {
+                        query.center = target.position.sub(Vec2::build(xs[column], ys[row]));
+                        this->tree.gather(&query, this->params.neighbor_distance, this->engine.opening_angle, &sums);
+                        this->tree.separate(&query, this->params.separation_distance, &sums);
+                    }
                 }
-                VectorData pointer = VectorData::build(relative);
 
-                target.cohesion(&pointer, &cohesion_force, &cohesion_count, &this->params);
-                target.alignment(&pointer, &alignment_force, &alignment_count, &this->params, &other);
-                target.separation(&pointer, &separation_force, &this->params);
+                if (sums.count > 0) {
+                    acceleration.add_assign(sums.cohesion.div(sums.count).mul(this->params.cohesion));
+                    acceleration.add_assign(sums.alignment.div(sums.count).mul(this->params.alignment));
+                }
+                acceleration.add_assign(sums.separation.mul(this->params.separation));
+            }
+        });
+    }
+
+    // `candidates(visit)` calls `visit(index, relative)` for every boid that might be a neighbor of boid i, with
+    // `relative` pointing from boid i to it; the cone and radii are tested as in accumulate_cell. With a nearest cap
+    // the visible candidates go through a NearestHeap first and only those it keeps steer
+    template <typename Rules, typename Candidates> void accumulate_boid(int i, Candidates candidates) {
+        Boid &target = this->boids[i];
+        Vec2 &acceleration = this->accelerations[i];
+        float neighbor_squared = this->params.neighbor_distance * this->params.neighbor_distance;
+        float separation_squared = this->params.separation_distance * this->params.separation_distance;
+        float cone = cos(this->params.peripheral_angle);
+        float speed = target.velocity.length();
+        int nearest = this->params.nearest_neighbors;
+        NearestHeap heap = NearestHeap::build(nearest, std::max(neighbor_squared, separation_squared));
+
+        Vec2 cohesion_force = Vec2::zeros();
+        Vec2 alignment_force = Vec2::zeros();
+        Vec2 separation_force = Vec2::zeros();
+        int count = 0;
+
+        auto steer = [&](Vec2 relative, float distance_squared, const Vec2 &velocity) {
+            if constexpr (Rules::cohesion || Rules::alignment) {
+                if (distance_squared <= neighbor_squared) {
+                    count += 1;
+                    if constexpr (Rules::cohesion) {
+                        cohesion_force.add_assign(relative);
+                    }
+                    if constexpr (Rules::alignment) {
+                        alignment_force.add_assign(velocity);
+                    }
+                }
+            }
+            if constexpr (Rules::separation) {
+                if (distance_squared <= separation_squared && distance_squared >= 1e-8) {
+                    separation_force.add_assign(relative.mul(-1 / distance_squared));
+                }
             }
+        };
 
-            if (cohesion_count > 0) {
-                cohesion_force.div_assign(cohesion_count);
-                cohesion_force.mul_assign(this->params.cohesion);
-                target.acceleration.add_assign(cohesion_force);
+        candidates([&](int index, Vec2 relative) {
+            if (index == i) {
+                return;
+            }
+            float distance_squared = relative.length_squared();
+            if constexpr (Rules::cone) {
+                float facing = target.velocity.inner_product(relative);
+                float scale = speed * relative.length();
+                if (facing < cone * scale && facing >= -scale) {
+                    return;
+                }
             }
+            if (nearest > 0) {
+                heap.offer(NearestCandidate{
+                    .distance_squared = distance_squared,
+                    .index = index,
+                    .relative = relative,
+                    .velocity = this->boids[index].velocity,
+                });
+                return;
+            }
+            steer(relative, distance_squared, this->boids[index].velocity);
+        });
 
-            if (alignment_count > 0) {
-                alignment_force.div_assign(alignment_count);
-                alignment_force.mul_assign(this->params.alignment);
-                target.acceleration.add_assign(alignment_force);
+        if (nearest > 0) {
+            heap.sort();
+            for (int k = 0; k < heap.count; k += 1) {
+                steer(heap.items[k].relative, heap.items[k].distance_squared, heap.items[k].velocity);
             }
+        }
+
+        if (count > 0) {
+            cohesion_force.div_assign(count);
+            cohesion_force.mul_assign(this->params.cohesion);
+            acceleration.add_assign(cohesion_force);
+            alignment_force.div_assign(count);
+            alignment_force.mul_assign(this->params.alignment);
+            acceleration.add_assign(alignment_force);
+        }
+
+        separation_force.mul_assign(this->params.separation);
+        acceleration.add_assign(separation_force);
+    }
 
-            separation_force.mul_assign(this->params.separation);
-            target.acceleration.add_assign(separation_force);
+    void update_boids(BoundingBox *bounds, float delta_time) {
+        this->reordered = false;
+        if (this->engine.reorder_interval > 0 && this->step % this->engine.reorder_interval == 0) {
+            this->reorder(bounds);
+        }
+        this->step += 1;
+        this->populate_map(bounds);
+        if (this->fused()) {
+            this->step_fused(bounds, delta_time);
+            return;
         }
+        this->accumulate_forces(bounds);
+        this->integrate_boids(bounds, delta_time);
+    }
+
+    void integrate_boids(BoundingBox *bounds, float delta_time) {
+        PROFILE_SCOPE("BoidManager::integrate");
+        bool wrap = this->engine.boundary == BOUNDARY_TORUS;
+        this->accelerations.resize(this->boids.size());
+        Boid *boids = this->boids.data();
+        Vec2 *accelerations = this->accelerations.data();
+        dispatch_kernels(this->engine.isa, [&]<typename K>() {
+            this->workers()->parallel_for(this->boids.size(), [&](int begin, int end) {
+                if (wrap) {
+                    K::template integrate<true>(boids, accelerations, begin, end, bounds, &this->params, delta_time);
+                } else {
+                    K::template integrate<false>(boids, accelerations, begin, end, bounds, &this->params, delta_time);
+                }
+            });
+        });
+    }
+
+    // replaces the whole flock, dropping everything that tracked the old one by index
+    void load(const Boid *boids, int count) {
+        this->boids.assign(boids, boids + count);
+        this->grid.tracking = false;
+        this->lists.anchors.clear();
+        this->reordered = false;
+    }
 
-        for (Boid &boid : this->boids) {
-            boid.avoid_walls(bounds, &this->params);
-            boid.integrate(delta_time);
-            boid.clamp_speed(this->params.max_speed, this->params.min_speed);
-            boid.move(delta_time);
-            boid.contain(bounds);
-            boid.reset_forces();
+    // sorts boid storage along a z-order curve of grid cells, so boids that share a stencil share cache lines too;
+    // anything holding boid indices across steps has to go through `remap`
+    void reorder(BoundingBox *bounds) {
+        PROFILE_SCOPE("BoidManager::reorder");
+        ThreadPool *pool = this->workers();
+        int count = this->boids.size();
+        float size = fmax(this->params.neighbor_distance, this->params.separation_distance);
+        int width = (int)(bounds->width() / size + 1);
+        int height = (int)(bounds->height() / size + 1);
+
+        this->sorter.resize(count);
+        pool->parallel_for(count, [&](int begin, int end) {
+            for (int i = begin; i < end; i += 1) {
+                const Vec2 &position = this->boids[i].position;
+                uint32_t key = UINT32_MAX;
+                if (std::isfinite(position.x) && std::isfinite(position.y)) {
+                    int x = std::clamp((int)((position.x - bounds->xmin) / size), 0, width - 1);
+                    int y = std::clamp((int)((position.y - bounds->ymin) / size), 0, height - 1);
+                    key = morton_code(x, y);
+                }
+                this->sorter.keys[i] = key;
+                this->sorter.values[i] = i;
+            }
+        });
+        this->sorter.sort(pool);
+
+        this->order.swap(this->sorter.values);
+        this->remap.resize(count);
+        this->sorted_boids.resize(count);
+        pool->parallel_for(count, [&](int begin, int end) {
+            for (int k = begin; k < end; k += 1) {
+                this->remap[this->order[k]] = k;
+                this->sorted_boids[k] = this->boids[this->order[k]];
+            }
+        });
+        this->boids.swap(this->sorted_boids);
+
+        this->grid.remap(this->order, this->remap);
+        // lists hold indices per boid, a fresh build is as cheap as permuting them and reorders are rare
+        this->lists.anchors.clear();
+        this->reordered = true;
+    }
+
+    // the reference kernel always runs on the calling thread, everything else uses `engine.threads` workers
+    ThreadPool *workers() {
+        if (!this->pool) {
+            this->pool = std::make_shared<ThreadPool>();
         }
+        int threads = this->engine.kernel == KERNEL_REFERENCE ? 1 : this->engine.threads;
+        this->pool->resize(threads);
+        return this->pool.get();
     }
 } BoidManager;
 
 typedef struct World {
     BoundingBox bounds;
     BoidManager data;
+    // the n-th boid the world ever spawns draws from stream n of `seed`
+    uint64_t seed;
+    uint64_t spawned;
 
     void add_boid() {
-        int x = rand() % (int)this->bounds.xmax;
-        int y = rand() % (int)this->bounds.ymax;
-        float angle = (float)rand() / RAND_MAX * TAU;
+        Random random = Random::build(this->seed).split(this->spawned);
+        this->spawned += 1;
+        float x = this->bounds.xmin + random.unit() * this->bounds.width();
+        float y = this->bounds.ymin + random.unit() * this->bounds.height();
+        float angle = random.unit() * TAU;
         Vec2 velocity = Vec2::build(cos(angle), sin(angle)).mul(this->data.params.max_speed);
         data.boids.push_back(Boid::build(Vec2::build(x, y), velocity));
     }
 
     void update(float delta_time) {
+        PROFILE_SCOPE("World::update");
         this->data.update_boids(&this->bounds, delta_time);
+        this->resize_flock();
+    }
 
-        while (this->data.boids.size() < this->data.params.boid_count) {
+    void resize_flock() {
+        // one reallocation for the whole growth, still doubling when the count creeps up a little at a time
+        if (this->data.params.boid_count > (int)this->data.boids.capacity()) {
+            this->data.boids.reserve(std::max<size_t>(this->data.params.boid_count, this->data.boids.capacity() * 2));
+        }
+        while ((int)this->data.boids.size() < this->data.params.boid_count) {
             this->add_boid();
         }
-        while (this->data.boids.size() > this->data.params.boid_count) {
+        while ((int)this->data.boids.size() > this->data.params.boid_count) {
             this->data.boids.pop_back();
         }
     }
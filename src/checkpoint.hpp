@@ -0,0 +1,131 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "boids.hpp"
+#include "mapped.hpp"
+
+#define CHECKPOINT_MAGIC "CBOIDSCK"
+#define CHECKPOINT_VERSION 4
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+// the boids start on a page boundary, so the mapped array is as aligned as any allocation
+#define CHECKPOINT_ALIGNMENT 4096
+
+// the file is this header and then `boid_count` raw Boids at `boid_offset`; a build whose layout differs in any
+// of the recorded sizes refuses the file rather than guessing
+typedef struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t header_size;
+    uint32_t boid_size;
+    uint64_t boid_count;
+    uint64_t boid_offset;
+    BoundingBox bounds;
+    BoidParams params;
+    uint64_t seed;
+    uint64_t spawned;
+} CheckpointHeader;
+
+static const char *check_checkpoint(const CheckpointHeader *header, uint64_t size) {
+    if (size < sizeof(CheckpointHeader) || memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0) {
+        return "not a boids checkpoint";
+    }
+    if (header->version != CHECKPOINT_VERSION) {
+        return "unsupported checkpoint version";
+    }
+    if (header->byte_order != CHECKPOINT_BYTE_ORDER) {
+        return "checkpoint was written with the other byte order";
+    }
+    if (header->header_size != sizeof(CheckpointHeader) || header->boid_size != sizeof(Boid)) {
+        return "checkpoint layout does not match this build";
+    }
+    if (header->boid_offset % alignof(Boid) != 0 || header->boid_offset > size ||
+        header->boid_count > (size - header->boid_offset) / sizeof(Boid) || header->boid_count > INT32_MAX) {
+        return "checkpoint is truncated";
+    }
+    return nullptr;
+}
+
+// a checkpoint mapped read-only so its header can be checked before anything is read; the boids are not used in
+// place, a restore copies them into the flock
+typedef struct CheckpointFile {
+    const CheckpointHeader *header;
+    const Boid *boids;
+    MappedFile mapping;
+    const char *error;
+
+    static CheckpointFile map(const char *path) {
+        CheckpointFile file = CheckpointFile{};
+        file.mapping = MappedFile::map(path);
+        if (file.mapping.memory == nullptr) {
+            file.error = file.mapping.error ? file.mapping.error : "not a boids checkpoint";
+            return file;
+        }
+        file.mapping.will_need();
+
+        file.header = (const CheckpointHeader *)file.mapping.memory;
+        file.error = check_checkpoint(file.header, file.mapping.size);
+        if (file.error == nullptr) {
+            file.boids = (const Boid *)((const char *)file.mapping.memory + file.header->boid_offset);
+        }
+        return file;
+    }
+
+    bool valid() const {
+        return this->error == nullptr;
+    }
+
+    int boid_count() const {
+        return this->valid() ? (int)this->header->boid_count : 0;
+    }
+
+    // the flock lives in a std::vector, which cannot adopt mapped pages, so this is one block copy of every boid
+    // and not a zero-copy load. The spawn counter comes along, boids added later are the ones the saved run would
+    // have added
+    void restore(World *world) const {
+        world->bounds = this->header->bounds;
+        world->data.params = this->header->params;
+        world->data.params.boid_count = this->boid_count();
+        world->seed = this->header->seed;
+        world->spawned = this->header->spawned;
+        world->data.load(this->boids, this->boid_count());
+    }
+
+    void unmap() {
+        this->mapping.unmap();
+        *this = CheckpointFile{.error = "checkpoint is not mapped"};
+    }
+} CheckpointFile;
+
+// writes the header, pads to the page boundary and streams the boid array out as it sits in memory
+static bool save_checkpoint(const char *path, const World *world) {
+    const std::vector<Boid> &boids = world->data.boids;
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.byte_order = CHECKPOINT_BYTE_ORDER;
+    header.header_size = sizeof(CheckpointHeader);
+    header.boid_size = sizeof(Boid);
+    header.boid_count = boids.size();
+    header.boid_offset = CHECKPOINT_ALIGNMENT;
+    header.bounds = world->bounds;
+    header.params = world->data.params;
+    header.seed = world->seed;
+    header.spawned = world->spawned;
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    char padding[CHECKPOINT_ALIGNMENT - sizeof(CheckpointHeader)] = {};
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(padding, sizeof(padding), 1, file) == 1 &&
+                   fwrite(boids.data(), sizeof(Boid), boids.size(), file) == boids.size();
+    return fclose(file) == 0 && written;
+}
+
+#endif
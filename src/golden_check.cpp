@@ -0,0 +1,355 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "boids.hpp"
+
+#define GOLDEN_MAGIC "CBOIDSGD"
+#define GOLDEN_VERSION 1
+#define GOLDEN_BYTE_ORDER 0x01020304u
+// steps from identical state differ by float rounding, around 1e-4 px; a boid past this took a different branch
+#define GOLDEN_POSITION_TOLERANCE 1e-3f
+#define GOLDEN_VELOCITY_TOLERANCE 2e-2f
+
+// what the trajectory was made from, checked against the scenario so a stale file is not compared; the frames
+// follow as `steps + 1` arrays of `boid_count` GoldenBoids
+typedef struct GoldenHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t boid_size;
+    uint32_t boid_count;
+    uint32_t steps;
+    uint32_t boundary;
+    uint64_t seed;
+    float delta_time;
+    BoundingBox bounds;
+    BoidParams params;
+} GoldenHeader;
+
+typedef struct GoldenBoid {
+    Vec2 position;
+    Vec2 velocity;
+} GoldenBoid;
+
+typedef struct Scenario {
+    const char *name;
+    uint64_t seed;
+    int steps;
+    Boundary boundary;
+    BoundingBox bounds;
+    BoidParams params;
+} Scenario;
+
+// an accelerated engine configuration, and the share of boids it may put past tolerance on one step
+typedef struct GoldenPath {
+    const char *name;
+    EngineParams engine;
+    float outliers;
+} GoldenPath;
+
+typedef struct Trajectory {
+    GoldenHeader header;
+    std::vector<GoldenBoid> frames;
+
+    const GoldenBoid *frame(int step) const {
+        return this->frames.data() + (size_t)step * this->header.boid_count;
+    }
+} Trajectory;
+
+World spawn(const Scenario *scenario, const EngineParams *engine) {
+    World world = World{.bounds = scenario->bounds, .seed = scenario->seed};
+    world.data.params = scenario->params;
+    world.data.engine = *engine;
+    world.data.engine.boundary = scenario->boundary;
+    world.resize_flock();
+    return world;
+}
+
+GoldenHeader describe(const Scenario *scenario) {
+    GoldenHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GOLDEN_MAGIC, sizeof(header.magic));
+    header.version = GOLDEN_VERSION;
+    header.byte_order = GOLDEN_BYTE_ORDER;
+    header.boid_size = sizeof(GoldenBoid);
+    header.boid_count = scenario->params.boid_count;
+    header.steps = scenario->steps;
+    header.boundary = scenario->boundary;
+    header.seed = scenario->seed;
+    header.delta_time = 0.05;
+    header.bounds = scenario->bounds;
+    header.params = scenario->params;
+    return header;
+}
+
+void capture(const World *world, std::vector<GoldenBoid> *frames) {
+    for (const Boid &boid : world->data.boids) {
+        frames->push_back(GoldenBoid{.position = boid.position, .velocity = boid.velocity});
+    }
+}
+
+// the scalar reference loop on one thread, free running from the seeded spawn
+bool write_golden(const Scenario *scenario, const char *path) {
+    EngineParams engine = EngineParams{.kernel = KERNEL_REFERENCE, .threads = 1};
+    World world = spawn(scenario, &engine);
+    Trajectory trajectory = Trajectory{.header = describe(scenario)};
+    capture(&world, &trajectory.frames);
+    for (int step = 0; step < scenario->steps; step += 1) {
+        world.update(trajectory.header.delta_time);
+        capture(&world, &trajectory.frames);
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = fwrite(&trajectory.header, sizeof(GoldenHeader), 1, file) == 1 &&
+                   fwrite(trajectory.frames.data(), sizeof(GoldenBoid), trajectory.frames.size(), file) ==
+                       trajectory.frames.size();
+    return fclose(file) == 0 && written;
+}
+
+const char *read_golden(const Scenario *scenario, const char *path, Trajectory *trajectory) {
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        return "cannot open golden trajectory, make golden-update writes it";
+    }
+    GoldenHeader expected = describe(scenario);
+    bool read = fread(&trajectory->header, sizeof(GoldenHeader), 1, file) == 1;
+    if (!read || memcmp(&trajectory->header, &expected, sizeof(GoldenHeader)) != 0) {
+        fclose(file);
+        return "golden trajectory does not match the scenario, make golden-update rewrites it";
+    }
+    trajectory->frames.resize((size_t)(expected.steps + 1) * expected.boid_count);
+    read = fread(trajectory->frames.data(), sizeof(GoldenBoid), trajectory->frames.size(), file) ==
+           trajectory->frames.size();
+    fclose(file);
+    return read ? nullptr : "golden trajectory is truncated";
+}
+
+// steps the path alongside the reference trajectory. After each step the path is compared, then put back on the
+// trajectory in place, so one step's rounding never compounds into chaos while grids, neighbor lists and
+// reorders carry over from step to step as they do in a real run
+bool check_path(const Scenario *scenario, const Trajectory *trajectory, const GoldenPath *path, Isa isa) {
+    EngineParams engine = path->engine;
+    engine.isa = isa;
+    World world = spawn(scenario, &engine);
+    int count = trajectory->header.boid_count;
+    bool wrap = scenario->boundary == BOUNDARY_TORUS;
+    std::vector<int> ids(count);
+    std::vector<int> next_ids(count);
+    for (int k = 0; k < count; k += 1) {
+        ids[k] = k;
+    }
+
+    double position_error = 0;
+    double velocity_error = 0;
+    int outliers = 0;
+    for (int step = 0; step < (int)trajectory->header.steps; step += 1) {
+        const GoldenBoid *from = trajectory->frame(step);
+        const GoldenBoid *to = trajectory->frame(step + 1);
+        for (int k = 0; k < count; k += 1) {
+            world.data.boids[k].position = from[ids[k]].position;
+            world.data.boids[k].velocity = from[ids[k]].velocity;
+        }
+
+        world.update(trajectory->header.delta_time);
+        if (world.data.reordered) {
+            for (int k = 0; k < count; k += 1) {
+                next_ids[k] = ids[world.data.order[k]];
+            }
+            ids.swap(next_ids);
+        }
+
+        for (int k = 0; k < count; k += 1) {
+            const Boid &boid = world.data.boids[k];
+            const GoldenBoid &expected = to[ids[k]];
+            Vec2 moved = wrap ? scenario->bounds.box_wrapped_postion(&expected.position, &boid.position)
+                              : boid.position.sub(expected.position);
+            float position = moved.length();
+            float velocity = boid.velocity.sub(expected.velocity).length();
+            // nan compares false both ways, so it has to count as an outlier explicitly
+            if (!(position <= GOLDEN_POSITION_TOLERANCE && velocity <= GOLDEN_VELOCITY_TOLERANCE)) {
+                outliers += 1;
+            }
+            position_error = std::max<double>(position_error, position);
+            velocity_error = std::max<double>(velocity_error, velocity);
+        }
+    }
+
+    int compared = count * trajectory->header.steps;
+    bool passed = outliers <= path->outliers * compared;
+    printf("  %-22s %14.3e %14.3e %8d/%d%s\n", path->name, position_error, velocity_error, outliers, compared,
+           passed ? "" : "  FAILED");
+    return passed;
+}
+
+// runs the path free from the seeded spawn on one thread, on three and on its own thread count: however the
+// cells fall to workers, every boid of every step has to come out the same to the bit
+bool check_threads(const Scenario *scenario, const Trajectory *trajectory, const GoldenPath *path, Isa isa) {
+    int threads[3] = {1, 3, path->engine.threads};
+    std::vector<GoldenBoid> runs[3];
+    for (int run = 0; run < 3; run += 1) {
+        EngineParams engine = path->engine;
+        engine.isa = isa;
+        engine.threads = threads[run];
+        World world = spawn(scenario, &engine);
+        for (int step = 0; step < scenario->steps; step += 1) {
+            world.update(trajectory->header.delta_time);
+            capture(&world, &runs[run]);
+        }
+    }
+
+    int differing = 0;
+    for (int k = 0; k < (int)runs[0].size(); k += 1) {
+        if (memcmp(&runs[0][k], &runs[1][k], sizeof(GoldenBoid)) != 0 ||
+            memcmp(&runs[0][k], &runs[2][k], sizeof(GoldenBoid)) != 0) {
+            differing += 1;
+        }
+    }
+    bool passed = differing == 0;
+    printf("  %-22s %14s %14s %8d/%d%s\n", path->name, "", "", differing, (int)runs[0].size(),
+           passed ? "" : "  FAILED");
+    return passed;
+}
+
+// replays every accelerated engine path against trajectories of the scalar reference kernel kept in `directory`;
+// `--update` rewrites them, which is only right after a deliberate change to the reference itself
+int main(int argc, char *argv[]) {
+    const char *directory = argc > 1 ? argv[1] : "golden";
+    bool update = argc > 2 && strcmp(argv[2], "--update") == 0;
+
+    BoidParams params = BoidParams{
+        .vertices = 3,
+        .boid_count = 400,
+        .max_speed = 200,
+        .min_speed = 75,
+        .boid_scale = 10,
+        .neighbor_distance = 100,
+        .separation_distance = 25,
+        .cohesion = 0.625,
+        .alignment = 2.5,
+        .separation = 1000,
+        .peripheral_angle = PI / 6,
+        .wall_distance = 150,
+        .wall_strength = 100000,
+    };
+    BoidParams nearest = params;
+    nearest.nearest_neighbors = 7;
+    BoundingBox bounds = BoundingBox{.xmin = 0, .xmax = 640, .ymin = 0, .ymax = 360};
+    // a torus 2.5 reaches wide and 1.8 high, too short to wrap through the stencil on either axis: every backend has
+    // to find pairs across the seam by their nearest image, and on the short axis only there
+    BoundingBox narrow = BoundingBox{.xmin = 0, .xmax = 250, .ymin = 0, .ymax = 180};
+    BoidParams narrow_params = params;
+    narrow_params.boid_count = 150;
+    BoidParams narrow_nearest = nearest;
+    narrow_nearest.boid_count = 150;
+    Scenario scenarios[] = {
+        {.name = "walls", .seed = 1, .steps = 16, .boundary = BOUNDARY_WALLS, .bounds = bounds, .params = params},
+        {.name = "torus", .seed = 2, .steps = 16, .boundary = BOUNDARY_TORUS, .bounds = bounds, .params = params},
+        {.name = "nearest_walls", .seed = 3, .steps = 16, .boundary = BOUNDARY_WALLS, .bounds = bounds,
+         .params = nearest},
+        {.name = "nearest_torus", .seed = 4, .steps = 16, .boundary = BOUNDARY_TORUS, .bounds = bounds,
+         .params = nearest},
+        {.name = "narrow_torus", .seed = 5, .steps = 16, .boundary = BOUNDARY_TORUS, .bounds = narrow,
+         .params = narrow_params},
+        {.name = "nearest_narrow_torus", .seed = 6, .steps = 16, .boundary = BOUNDARY_TORUS, .bounds = narrow,
+         .params = narrow_nearest},
+    };
+
+    // the exact tree drops boids straight behind the viewer, which the grid kernels keep, so a few boids may differ
+    GoldenPath paths[] = {
+        {"reference", EngineParams{.kernel = KERNEL_REFERENCE, .threads = 1}, 0},
+        {"soa", EngineParams{.kernel = KERNEL_SOA, .threads = 1}, 0},
+        {"soa 4 threads", EngineParams{.kernel = KERNEL_SOA, .threads = 4}, 0},
+        {"simd", EngineParams{.kernel = KERNEL_SIMD, .threads = 1}, 0},
+        {"simd 4 threads", EngineParams{.kernel = KERNEL_SIMD, .threads = 4}, 0},
+        {"simd static schedule", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .schedule = SCHEDULE_STATIC}, 0},
+        {"simd incremental grid", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .grid = GRID_INCREMENTAL}, 0},
+        {"verlet lists", EngineParams{.kernel = KERNEL_REFERENCE, .threads = 4, .neighbors = NEIGHBORS_VERLET,
+                                      .skin = 20}, 0},
+        {"simd morton reorder", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .reorder_interval = 3}, 0},
+        {"soa fused", EngineParams{.kernel = KERNEL_SOA, .threads = 1, .integration = INTEGRATION_FUSED}, 0},
+        {"simd fused", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .integration = INTEGRATION_FUSED}, 0},
+        {"soa half stencil", EngineParams{.kernel = KERNEL_SOA, .threads = 1, .stencil = STENCIL_HALF}, 0},
+        {"simd half stencil", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .stencil = STENCIL_HALF}, 0},
+        {"simd half static", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .schedule = SCHEDULE_STATIC,
+                                          .stencil = STENCIL_HALF}, 0},
+        {"simd half fused", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .integration = INTEGRATION_FUSED,
+                                         .stencil = STENCIL_HALF}, 0},
+        {"tree", EngineParams{.kernel = KERNEL_SIMD, .threads = 4, .neighbors = NEIGHBORS_TREE}, 0.005},
+    };
+
+    bool passed = true;
+    for (const Scenario &scenario : scenarios) {
+        std::string path = std::string(directory) + "/" + scenario.name + ".golden";
+        if (update) {
+            bool written = write_golden(&scenario, path.c_str());
+            printf("%s %s\n", written ? "wrote" : "cannot write", path.c_str());
+            passed = passed && written;
+            continue;
+        }
+
+        Trajectory trajectory = Trajectory{};
+        const char *error = read_golden(&scenario, path.c_str(), &trajectory);
+        if (error != nullptr) {
+            fprintf(stderr, "FAILED: %s: %s\n", path.c_str(), error);
+            passed = false;
+            continue;
+        }
+
+        // the seeded spawn and the reference kernel, free running on one thread as write_golden ran them, have to
+        // reproduce every stored frame to the bit before any other path is worth comparing: the paths below restart
+        // each step from the stored frame, so a change to the reference itself would slip past them
+        EngineParams engine = EngineParams{.kernel = KERNEL_REFERENCE, .threads = 1};
+        World world = spawn(&scenario, &engine);
+        std::vector<GoldenBoid> frames;
+        capture(&world, &frames);
+        for (int step = 0; step < scenario.steps; step += 1) {
+            world.update(trajectory.header.delta_time);
+            capture(&world, &frames);
+        }
+        int drifted = 0;
+        for (int k = 0; k < (int)frames.size(); k += 1) {
+            if (memcmp(&frames[k], &trajectory.frames[k], sizeof(GoldenBoid)) != 0) {
+                drifted += 1;
+            }
+        }
+        bool reproduced = drifted == 0;
+        passed = passed && reproduced;
+
+        printf("%s: %d boids, %d steps, seed %llu, reference off the stored frames %d/%d%s\n", scenario.name,
+               scenario.params.boid_count, scenario.steps, (unsigned long long)scenario.seed, drifted,
+               (int)frames.size(), reproduced ? "" : "  FAILED: golden-update if the reference changed on purpose");
+        // every instruction set variant this cpu runs has to stay on the same trajectory
+        for (Isa isa : {ISA_BASELINE, ISA_AVX2, ISA_AVX512}) {
+            if (resolve_isa(isa) != isa) {
+                continue;
+            }
+            printf("  %-22s %14s %14s %14s\n", isa_name(isa), "position error", "velocity error", "outliers");
+            for (const GoldenPath &golden_path : paths) {
+                // the tree has no nearest cap to check
+                if (scenario.params.nearest_neighbors > 0 && golden_path.engine.neighbors == NEIGHBORS_TREE) {
+                    continue;
+                }
+                passed = check_path(&scenario, &trajectory, &golden_path, isa) && passed;
+            }
+            printf("  %-22s %44s\n", "threaded paths", "boids off the 1-thread run");
+            for (const GoldenPath &golden_path : paths) {
+                if (golden_path.engine.threads <= 1 ||
+                    (scenario.params.nearest_neighbors > 0 && golden_path.engine.neighbors == NEIGHBORS_TREE)) {
+                    continue;
+                }
+                passed = check_threads(&scenario, &trajectory, &golden_path, isa) && passed;
+            }
+        }
+    }
+
+    if (!passed) {
+        fprintf(stderr, "FAILED: an engine path left the reference trajectory\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,471 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "boids.hpp"
+#include "checkpoint.hpp"
+#include "recorder.hpp"
+#include "replay.hpp"
+
+// every operator new in the process, so a run can tell whether its steady state still reaches the allocator
+static std::atomic<long long> allocations;
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *memory = malloc(size > 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
+
+typedef struct FloatFlag {
+    const char *name;
+    float *value;
+} FloatFlag;
+
+typedef struct IntFlag {
+    const char *name;
+    int *value;
+} IntFlag;
+
+typedef struct Options {
+    int steps;
+    int seed;
+    float delta_time;
+    const char *kernel;
+    const char *schedule;
+    const char *grid;
+    const char *neighbors;
+    const char *boundary;
+    const char *trace;
+    const char *save;
+    const char *restore;
+    const char *record;
+    const char *replay;
+    int steady_after;
+} Options;
+
+void usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--boids N] [--steps N] [--seed N] [--dt SECONDS] [--width W] [--height H]\n"
+            "          [--max-speed F] [--min-speed F] [--neighbor-distance F] [--separation-distance F]\n"
+            "          [--cohesion F] [--alignment F] [--separation F] [--peripheral-angle RADIANS]\n"
+            "          [--wall-distance F] [--wall-strength F] [--nearest K]\n"
+            "          [--kernel reference|soa|simd] [--threads N] [--schedule tiles|static]\n"
+            "          [--grid rebuild|incremental] [--neighbors grid|verlet|tree|auto] [--skin F]\n"
+            "          [--opening-angle F] [--reorder STEPS] [--boundary walls|torus] [--integration separate|fused]\n"
+            "          [--stencil full|half] [--trace trace.json] [--assert-no-alloc WARMUP_STEPS]\n"
+            "          [--save checkpoint.bin] [--restore checkpoint.bin]\n"
+            "          [--record trajectory.bin] [--record-every STEPS] [--replay trajectory.bin]\n"
+            "--integration fused is kept for comparison: it runs slower than separate today\n"
+            "BOIDS_ISA=baseline|avx2|avx512 forces the instruction set the hot loops run with\n",
+            program);
+}
+
+bool parse_kernel(const char *name, Kernel *kernel) {
+    const char *names[] = {"reference", "soa", "simd"};
+    for (int i = 0; i < 3; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *kernel = (Kernel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_schedule(const char *name, Schedule *schedule) {
+    const char *names[] = {"tiles", "static"};
+    for (int i = 0; i < 2; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *schedule = (Schedule)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_grid(const char *name, GridUpdate *grid) {
+    const char *names[] = {"rebuild", "incremental"};
+    for (int i = 0; i < 2; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *grid = (GridUpdate)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_neighbors(const char *name, NeighborMode *neighbors) {
+    const char *names[] = {"grid", "verlet", "tree", "auto"};
+    for (int i = 0; i < 4; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *neighbors = (NeighborMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_stencil(const char *name, Stencil *stencil) {
+    const char *names[] = {"full", "half"};
+    for (int i = 0; i < 2; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *stencil = (Stencil)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_integration(const char *name, Integration *integration) {
+    const char *names[] = {"separate", "fused"};
+    for (int i = 0; i < 2; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *integration = (Integration)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_boundary(const char *name, Boundary *boundary) {
+    const char *names[] = {"walls", "torus"};
+    for (int i = 0; i < 2; i += 1) {
+        if (strcmp(name, names[i]) == 0) {
+            *boundary = (Boundary)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t hash_snapshot(const Snapshot *snapshot) {
+    uint64_t hash = 14695981039346656037ull;
+    const std::vector<Vec2> *arrays[] = {&snapshot->previous, &snapshot->positions, &snapshot->velocities};
+    for (const std::vector<Vec2> *array : arrays) {
+        const uint8_t *bytes = (const uint8_t *)array->data();
+        for (size_t i = 0; i < array->size() * sizeof(Vec2); i += 1) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// decodes a recording through the replay thread, front to back and then by seeking to scattered frames, which
+// have to come out exactly as they did in order
+int replay(const char *path, int threads) {
+    ReplayThread replay = ReplayThread{.threads = threads};
+    if (!replay.open(path)) {
+        fprintf(stderr, "cannot replay %s: %s\n", path, replay.file.error);
+        return 1;
+    }
+    int frames = replay.file.frame_count();
+    printf("replaying %s: %d frames, %d keyframes, %d boids, decoder threads: %d\n", path, frames,
+           (int)replay.file.keyframes.size(), replay.file.frames[0].count, threads);
+    replay.start();
+
+    std::vector<uint64_t> hashes(frames);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i += 1) {
+        const ReplaySlot *slot = replay.wait(i);
+        if (slot == nullptr) {
+            fprintf(stderr, "FAILED: frame %d does not decode\n", i);
+            return 1;
+        }
+        hashes[i] = hash_snapshot(&slot->snapshot);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("played: %.3f ms/frame, decoding %.3f ms/frame\n", 1000 * seconds / frames,
+           replay.decode_ns / std::max(replay.frames_decoded, 1LL) / 1e6);
+
+    int seeks = std::min(frames, 32);
+    double total = 0;
+    double longest = 0;
+    for (int k = 0; k < seeks; k += 1) {
+        int index = (k * 7919LL + frames / 2) % frames;
+        auto seeked = std::chrono::steady_clock::now();
+        replay.seek(index);
+        const ReplaySlot *slot = replay.wait(index);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - seeked).count();
+        if (slot == nullptr || hash_snapshot(&slot->snapshot) != hashes[index]) {
+            fprintf(stderr, "FAILED: seeking to frame %d decoded it differently\n", index);
+            return 1;
+        }
+        total += ms;
+        longest = std::max(longest, ms);
+    }
+    printf("seeks: %d, %.2f ms mean, %.2f ms max\n", seeks, total / std::max(seeks, 1), longest);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    World world = World{.bounds = BoundingBox{.xmin = 0, .xmax = 1920, .ymin = 0, .ymax = 1080}};
+    world.data.params = BoidParams{
+        .vertices = 3,
+        .boid_count = 10000,
+        .max_speed = 200,
+        .min_speed = 75,
+        .boid_scale = 10,
+        .neighbor_distance = 200,
+        .separation_distance = 50,
+        .cohesion = 0.625,
+        .alignment = 2.5,
+        .separation = 1000,
+        .peripheral_angle = PI / 6,
+        .wall_distance = 300,
+        .wall_strength = 100000,
+    };
+    world.data.engine = EngineParams{
+        .kernel = KERNEL_SIMD,
+        .threads = (int)std::thread::hardware_concurrency(),
+        // a boid moves max_speed * dt = 10 a step, so the lists last about four steps before one has moved half of it
+        .skin = 80,
+    };
+    RecorderOptions recording = RecorderOptions{
+        .decimation = 1,
+        .keyframe_interval = 60,
+        .position_bits = 16,
+        .velocity_bits = 12,
+    };
+    Options options = Options{
+        .steps = 1000,
+        .seed = 1,
+        .delta_time = 0.05,
+        .kernel = "simd",
+        .schedule = "tiles",
+        .grid = "rebuild",
+        .neighbors = "grid",
+        .boundary = "walls",
+        .steady_after = -1,
+    };
+
+    BoidParams *params = &world.data.params;
+    FloatFlag float_flags[] = {
+        {"--dt", &options.delta_time},
+        {"--width", &world.bounds.xmax},
+        {"--height", &world.bounds.ymax},
+        {"--max-speed", &params->max_speed},
+        {"--min-speed", &params->min_speed},
+        {"--neighbor-distance", &params->neighbor_distance},
+        {"--separation-distance", &params->separation_distance},
+        {"--cohesion", &params->cohesion},
+        {"--alignment", &params->alignment},
+        {"--separation", &params->separation},
+        {"--peripheral-angle", &params->peripheral_angle},
+        {"--wall-distance", &params->wall_distance},
+        {"--wall-strength", &params->wall_strength},
+        {"--skin", &world.data.engine.skin},
+        {"--opening-angle", &world.data.engine.opening_angle},
+    };
+    IntFlag int_flags[] = {
+        {"--boids", &params->boid_count},
+        {"--nearest", &params->nearest_neighbors},
+        {"--steps", &options.steps},
+        {"--seed", &options.seed},
+        {"--threads", &world.data.engine.threads},
+        {"--reorder", &world.data.engine.reorder_interval},
+        {"--assert-no-alloc", &options.steady_after},
+        {"--record-every", &recording.decimation},
+    };
+
+    for (int i = 1; i < argc; i += 1) {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            usage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "missing value for %s\n", argv[i]);
+            usage(argv[0]);
+            return 1;
+        }
+
+        bool known = false;
+        for (FloatFlag &flag : float_flags) {
+            if (strcmp(argv[i], flag.name) == 0) {
+                *flag.value = atof(argv[i + 1]);
+                known = true;
+            }
+        }
+        for (IntFlag &flag : int_flags) {
+            if (strcmp(argv[i], flag.name) == 0) {
+                *flag.value = atoi(argv[i + 1]);
+                known = true;
+            }
+        }
+        if (strcmp(argv[i], "--kernel") == 0) {
+            options.kernel = argv[i + 1];
+            known = parse_kernel(argv[i + 1], &world.data.engine.kernel);
+        }
+        if (strcmp(argv[i], "--schedule") == 0) {
+            options.schedule = argv[i + 1];
+            known = parse_schedule(argv[i + 1], &world.data.engine.schedule);
+        }
+        if (strcmp(argv[i], "--grid") == 0) {
+            options.grid = argv[i + 1];
+            known = parse_grid(argv[i + 1], &world.data.engine.grid);
+        }
+        if (strcmp(argv[i], "--neighbors") == 0) {
+            options.neighbors = argv[i + 1];
+            known = parse_neighbors(argv[i + 1], &world.data.engine.neighbors);
+        }
+        if (strcmp(argv[i], "--boundary") == 0) {
+            options.boundary = argv[i + 1];
+            known = parse_boundary(argv[i + 1], &world.data.engine.boundary);
+        }
+        if (strcmp(argv[i], "--integration") == 0) {
+            known = parse_integration(argv[i + 1], &world.data.engine.integration);
+        }
+        if (strcmp(argv[i], "--stencil") == 0) {
+            known = parse_stencil(argv[i + 1], &world.data.engine.stencil);
+        }
+        if (strcmp(argv[i], "--trace") == 0) {
+            options.trace = argv[i + 1];
+            known = true;
+        }
+        if (strcmp(argv[i], "--save") == 0) {
+            options.save = argv[i + 1];
+            known = true;
+        }
+        if (strcmp(argv[i], "--restore") == 0) {
+            options.restore = argv[i + 1];
+            known = true;
+        }
+        if (strcmp(argv[i], "--record") == 0) {
+            options.record = argv[i + 1];
+            known = true;
+        }
+        if (strcmp(argv[i], "--replay") == 0) {
+            options.replay = argv[i + 1];
+            known = true;
+        }
+        if (!known) {
+            fprintf(stderr, "unknown option %s %s\n", argv[i], argv[i + 1]);
+            usage(argv[0]);
+            return 1;
+        }
+        i += 1;
+    }
+
+    if (options.replay != nullptr) {
+        return replay(options.replay, world.data.engine.threads);
+    }
+
+    // a restored run takes its bounds, params and flock from the checkpoint, engine options still apply
+    if (options.restore != nullptr) {
+        auto mapped = std::chrono::steady_clock::now();
+        CheckpointFile checkpoint = CheckpointFile::map(options.restore);
+        if (!checkpoint.valid()) {
+            fprintf(stderr, "cannot restore %s: %s\n", options.restore, checkpoint.error);
+            return 1;
+        }
+        checkpoint.restore(&world);
+        checkpoint.unmap();
+        printf("restored %d boids from %s in %.2f ms\n", params->boid_count, options.restore,
+               std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mapped).count());
+    } else {
+        world.seed = options.seed;
+        world.resize_flock();
+    }
+
+    // neighbor lists only run the reference math, so say so rather than report a kernel that never ran
+    if (world.data.neighbor_mode() == NEIGHBORS_VERLET && world.data.engine.kernel != KERNEL_REFERENCE) {
+        fprintf(stderr, "warning: --neighbors verlet runs the reference math, --kernel %s is ignored\n",
+                options.kernel);
+        options.kernel = "reference";
+    }
+
+    printf("boids: %d, steps: %d, seed: %d, bounds: %.0fx%.0f\n", params->boid_count, options.steps, options.seed,
+           world.bounds.width(), world.bounds.height());
+    printf("kernel: %s, threads: %d, schedule: %s, grid: %s, neighbors: %s, boundary: %s, isa: %s\n", options.kernel,
+           world.data.engine.threads, options.schedule, options.grid, options.neighbors, options.boundary,
+           isa_name(resolve_isa(world.data.engine.isa)));
+    // only the grid kernels fuse or walk half the stencil, anything else asked to falls back
+    printf("integration: %s, stencil: %s\n", world.data.fused() ? "fused" : "separate",
+           world.data.half_stencil() ? "half" : "full");
+
+    TrajectoryRecorder recorder = TrajectoryRecorder{};
+    if (options.record != nullptr && !recorder.start(options.record, &recording)) {
+        fprintf(stderr, "cannot write %s\n", options.record);
+        return 1;
+    }
+
+    double migrated = 0;
+    long long steady_allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < options.steps; step += 1) {
+        if (step == options.steady_after) {
+            steady_allocations = allocations.load();
+        }
+        world.update(options.delta_time);
+        migrated += world.data.grid.migrated_fraction();
+        if (options.record != nullptr) {
+            recorder.record(&world, step + 1);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (options.steady_after >= 0 && options.steady_after < options.steps) {
+        steady_allocations = allocations.load() - steady_allocations;
+    }
+
+    printf("elapsed: %.3f s\n", seconds);
+    printf("steps/second: %.2f\n", options.steps / seconds);
+    printf("boid-updates/second: %.4g\n", (double)options.steps * params->boid_count / seconds);
+    if (world.data.engine.grid == GRID_INCREMENTAL) {
+        printf("migrated/step: %.2f%%\n", 100 * migrated / std::max(options.steps, 1));
+    }
+    if (world.data.engine.neighbors == NEIGHBORS_AUTO) {
+        printf("auto neighbors: %s\n", world.data.neighbor_mode() == NEIGHBORS_TREE ? "tree" : "grid");
+    }
+    if (world.data.engine.neighbors == NEIGHBORS_VERLET) {
+        printf("neighbor lists: rebuilt every %.2f steps, %.1f candidates/boid\n", world.data.lists.rebuild_interval(),
+               world.data.lists.candidates_per_boid());
+    }
+    if (options.record != nullptr) {
+        recorder.stop();
+        recorder.report(stdout);
+        if (recorder.failed) {
+            return 1;
+        }
+    }
+    if (options.save != nullptr) {
+        if (!save_checkpoint(options.save, &world)) {
+            fprintf(stderr, "cannot write %s\n", options.save);
+            return 1;
+        }
+        printf("saved %d boids to %s\n", (int)world.data.boids.size(), options.save);
+    }
+    if (options.steady_after >= 0) {
+        printf("allocations after step %d: %lld (frame arena grew %lld times)\n", options.steady_after,
+               steady_allocations, world.data.frame.growths);
+        if (steady_allocations > 0) {
+            fprintf(stderr, "FAILED: the steady state allocated\n");
+            return 1;
+        }
+    }
+
+#if defined(BOIDS_PROFILE)
+    Profiler::global().report(stdout);
+    if (options.trace != nullptr && !Profiler::global().write_trace(options.trace)) {
+        fprintf(stderr, "cannot write %s\n", options.trace);
+        return 1;
+    }
+#else
+    if (options.trace != nullptr) {
+        fprintf(stderr, "--trace needs a profiling build (make PROFILE=1)\n");
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef ISA_H
+#define ISA_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "simd.hpp"
+
+#if defined(BOIDS_ISA_VARIANTS)
+#include <cpuid.h>
+#endif
+
+// the instruction set the hot loops are compiled for, in increasing order. Baseline is whatever the build flags
+// target (SSE2 on x86-64); the others only exist in x86 builds from gcc or clang
+typedef enum Isa {
+    ISA_AUTO,
+    ISA_BASELINE,
+    ISA_AVX2,
+    ISA_AVX512,
+} Isa;
+
+static const char *isa_name(Isa isa) {
+    switch (isa) {
+    case ISA_AUTO:
+        return "auto";
+    case ISA_BASELINE:
+        return "baseline";
+    case ISA_AVX2:
+        return "avx2";
+    case ISA_AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+// the best variant this cpu runs: cpuid has to report the instructions and XCR0 has to show the os saves the
+// registers they use, ymm state for AVX2 and the opmask and full zmm state for AVX-512
+static Isa detect_isa() {
+#if defined(BOIDS_ISA_VARIANTS)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+        return ISA_BASELINE;
+    }
+    unsigned int xcr0;
+    unsigned int xcr0_high;
+    __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & bit_AVX2) || (xcr0 & 0x06) != 0x06) {
+        return ISA_BASELINE;
+    }
+    if ((ebx & bit_AVX512F) && (xcr0 & 0xe6) == 0xe6) {
+        return ISA_AVX512;
+    }
+    return ISA_AVX2;
+#else
+    return ISA_BASELINE;
+#endif
+}
+
+// BOIDS_ISA=baseline|avx2|avx512 forces a variant for benchmarks and tests; one this cpu cannot run falls back to
+// the best it can
+static Isa select_isa() {
+    Isa detected = detect_isa();
+    const char *forced = getenv("BOIDS_ISA");
+    if (forced == nullptr || *forced == 0) {
+        return detected;
+    }
+    for (Isa isa : {ISA_BASELINE, ISA_AVX2, ISA_AVX512}) {
+        if (strcmp(forced, isa_name(isa)) != 0) {
+            continue;
+        }
+        if (isa > detected) {
+            fprintf(stderr, "BOIDS_ISA=%s: this cpu runs up to %s\n", forced, isa_name(detected));
+            return detected;
+        }
+        return isa;
+    }
+    fprintf(stderr, "BOIDS_ISA=%s is not baseline, avx2 or avx512, using %s\n", forced, isa_name(detected));
+    return detected;
+}
+
+// the variant for ISA_AUTO, decided on first use
+static Isa runtime_isa() {
+    static Isa isa = select_isa();
+    return isa;
+}
+
+// an explicit request is capped at what this cpu runs
+static Isa resolve_isa(Isa requested) {
+    static Isa detected = detect_isa();
+    return requested == ISA_AUTO ? runtime_isa() : std::min(requested, detected);
+}
+
+#endif
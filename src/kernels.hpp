@@ -0,0 +1,730 @@
+// the hot loops of a step, compiled once per instruction set: boids.hpp includes this file for every variant inside
+// a namespace of its own and a target region, with BOIDS_LANES naming the widest lanes the variant has. Hence no
+// include guard, and no lambdas, since compilers disagree on whether a lambda picks up the target of its region
+
+// first `count` lanes set, clamped to the lane width
+template <typename L> L lanes_first(int count) {
+    count = count < 0 ? 0 : (count > 16 ? 16 : count);
+    return L::bits(&LANE_BITS[16 - count]);
+}
+
+// only lane `index` set, or no lanes when index is out of range
+template <typename L> L lanes_single(int index) {
+    if (index < 0 || index >= L::width) {
+        return L::bits(&LANE_BITS[16]);
+    }
+    return lanes_first<L>(index + 1).but_not(lanes_first<L>(index));
+}
+
+// nearest_offset over lanes, for an axis SpatialPartition folds; on any other axis offsets pass unchanged
+template <typename L> struct LaneFold {
+    bool active;
+    L length;
+    L half;
+    L minus_half;
+
+    static LaneFold build(bool active, float length) {
+        return LaneFold{
+            .active = active,
+            .length = L::broadcast(length),
+            .half = L::broadcast(length / 2),
+            .minus_half = L::broadcast(-length / 2),
+        };
+    }
+
+    // both masks come from the offset before either correction, as in the branches of nearest_offset
+    L apply(L offset) const {
+        if (!this->active) {
+            return offset;
+        }
+        L above = this->half.less(offset);
+        L below = offset.less(this->minus_half);
+        return offset.sub(this->length.keep(above)).add(this->length.keep(below));
+    }
+};
+
+typedef struct Kernels {
+    typedef BOIDS_LANES Lanes;
+
+    // each boid's grid key into `cells`, for SpatialPartition::sort_binned
+    static void bin(const SpatialPartition *grid, const Boid *boids, int begin, int end, int *cells) {
+        for (int i = begin; i < end; i += 1) {
+            cells[i] = grid->boid_key(&boids[i]);
+        }
+    }
+
+    // one boid's step from its flocking force; a torus has no walls to steer away from or bounce off, boids wrap
+    // around instead
+    template <bool Wrap>
+    static void advance(Boid *boid, Vec2 acceleration, BoundingBox *bounds, const BoidParams *params,
+                        float delta_time) {
+        if constexpr (!Wrap) {
+            acceleration.add_assign(boid->wall_repulsion(bounds, params));
+        }
+        boid->integrate(acceleration, delta_time);
+        boid->clamp_speed(params->max_speed, params->min_speed);
+        boid->move(delta_time);
+        if constexpr (Wrap) {
+            boid->wrap(bounds);
+        } else {
+            boid->contain(bounds);
+        }
+    }
+
+    // the second pass of a two-pass step, which leaves the forces zeroed for the next one
+    template <bool Wrap>
+    static void integrate(Boid *boids, Vec2 *accelerations, int begin, int end, BoundingBox *bounds,
+                          const BoidParams *params, float delta_time) {
+        for (int i = begin; i < end; i += 1) {
+            advance<Wrap>(&boids[i], accelerations[i], bounds, params, delta_time);
+            accelerations[i] = Vec2::zeros();
+        }
+    }
+
+    template <typename L, typename Rules>
+    static long long accumulate_forces(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params,
+                                       int cell_begin, int cell_end, PairSums *half, const FusedStep *fused) {
+        long long pairs = 0;
+        for (int cell = cell_begin; cell < cell_end; cell += 1) {
+            int begin = grid->cell_start[cell];
+            int end = begin + grid->cell_count[cell];
+            if (half != nullptr) {
+                pairs += accumulate_half<L, Rules>(arrays, grid, params, cell, begin, end,
+                                                   &half[grid->pair_class(cell)]);
+                continue;
+            }
+            if (params->nearest_neighbors > 0) {
+                pairs += accumulate_nearest<L, Rules>(arrays, grid, params, cell, begin, end, fused);
+                continue;
+            }
+            pairs += accumulate_cell<L, Rules>(arrays, grid, params, cell, begin, end, fused);
+        }
+        return pairs;
+    }
+
+    template <typename L, typename Rules>
+    static long long accumulate_item(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params,
+                                     const WorkItem *item, PairSums *half, const FusedStep *fused) {
+        long long pairs = 0;
+        for (int y = item->y0; y <= item->y1; y += 1) {
+            for (int x = item->x0; x <= item->x1; x += 1) {
+                int cell = grid->key(x, y);
+                int begin = grid->cell_start[cell];
+                int end = begin + grid->cell_count[cell];
+                if (item->slot_begin >= 0) {
+                    begin = item->slot_begin;
+                    end = item->slot_end;
+                }
+                if (half != nullptr) {
+                    pairs += accumulate_half<L, Rules>(arrays, grid, params, cell, begin, end,
+                                                       &half[grid->pair_class(cell)]);
+                    continue;
+                }
+                if (params->nearest_neighbors > 0) {
+                    pairs += accumulate_nearest<L, Rules>(arrays, grid, params, cell, begin, end, fused);
+                    continue;
+                }
+                pairs += accumulate_cell<L, Rules>(arrays, grid, params, cell, begin, end, fused);
+            }
+        }
+        return pairs;
+    }
+
+    // forces on the sorted boids [begin, end) of one cell, or with `fused` their next state; returns the candidate
+    // pairs it looked at
+    template <typename L, typename Rules>
+    static long long accumulate_cell(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params,
+                                     int cell, int begin, int end, const FusedStep *fused) {
+        if (begin == end) {
+            return 0;
+        }
+
+        float neighbor_squared = params->neighbor_distance * params->neighbor_distance;
+        float separation_squared = params->separation_distance * params->separation_distance;
+        // acos(ratio) > peripheral_angle without the acos or the division: ratio < cos(peripheral_angle) with both
+        // sides scaled by speed * distance. The ratios acos turns into nan are let through as the reference does:
+        // those below -1 by rounding, straight behind, and the zero over zero of a boid at rest or a coincident one
+        float cone = cos(params->peripheral_angle);
+
+        L neighbor_limit = L::broadcast(neighbor_squared);
+        L separation_limit = L::broadcast(separation_squared);
+        L separation_floor = L::broadcast(1e-8);
+        L one = L::broadcast(1);
+        L minus_one = L::broadcast(-1);
+        L cone_limit = L::broadcast(cone);
+        LaneFold<L> fold_x = LaneFold<L>::build(Rules::wrap && grid->fold_x, grid->length_x);
+        LaneFold<L> fold_y = LaneFold<L>::build(Rules::wrap && grid->fold_y, grid->length_y);
+
+        // every stencil row is at most two contiguous slices, each with the shift of the edge it lies across
+        int slices[6][2];
+        float shifts[6][2];
+        int slice_count = 0;
+        int span = 0;
+        const StencilSpan *columns = &grid->columns[(cell % grid->width) * 2];
+        const StencilSpan *rows = &grid->rows[(cell / grid->width) * 2];
+        for (int row = 0; row < 2; row += 1) {
+            for (int y = rows[row].first; y <= rows[row].last; y += 1) {
+                for (int column = 0; column < 2; column += 1) {
+                    if (columns[column].first > columns[column].last) {
+                        continue;
+                    }
+                    slices[slice_count][0] = grid->cell_start[grid->key(columns[column].first, y)];
+                    slices[slice_count][1] = grid->cell_start[grid->key(columns[column].last, y) + 1];
+                    shifts[slice_count][0] = columns[column].shift;
+                    shifts[slice_count][1] = rows[row].shift;
+                    span += slices[slice_count][1] - slices[slice_count][0];
+                    slice_count += 1;
+                }
+            }
+        }
+
+        for (int k = begin; k < end; k += 1) {
+            L target_vx = L::broadcast(arrays->vx[k]);
+            L target_vy = L::broadcast(arrays->vy[k]);
+            L target_speed = L::broadcast(sqrt(arrays->vx[k] * arrays->vx[k] + arrays->vy[k] * arrays->vy[k]));
+
+            L cohesion_x = L::zeros();
+            L cohesion_y = L::zeros();
+            L alignment_x = L::zeros();
+            L alignment_y = L::zeros();
+            L separation_x = L::zeros();
+            L separation_y = L::zeros();
+            L counter = L::zeros();
+
+            for (int slice = 0; slice < slice_count; slice += 1) {
+                // moving the target against the shift instead of every candidate along it
+                L target_x = L::broadcast(arrays->x[k] - shifts[slice][0]);
+                L target_y = L::broadcast(arrays->y[k] - shifts[slice][1]);
+                int slice_end = slices[slice][1];
+                for (int j = slices[slice][0]; j < slice_end; j += L::width) {
+                    L visible = lanes_first<L>(slice_end - j).but_not(lanes_single<L>(k - j));
+
+                    L relative_x = fold_x.apply(L::load(&arrays->x[j]).sub(target_x));
+                    L relative_y = fold_y.apply(L::load(&arrays->y[j]).sub(target_y));
+                    L distance_squared = relative_x.mul(relative_x).add(relative_y.mul(relative_y));
+                    if constexpr (Rules::cone) {
+                        L facing = target_vx.mul(relative_x).add(target_vy.mul(relative_y));
+                        L scale = target_speed.mul(distance_squared.sqrt());
+                        L outside = facing.less(cone_limit.mul(scale)).both(facing.greater_equal(minus_one.mul(scale)));
+                        visible = visible.but_not(outside);
+                    }
+
+                    if constexpr (Rules::cohesion || Rules::alignment) {
+                        L near = visible.both(distance_squared.less_equal(neighbor_limit));
+                        if constexpr (Rules::cohesion) {
+                            cohesion_x = cohesion_x.add(relative_x.keep(near));
+                            cohesion_y = cohesion_y.add(relative_y.keep(near));
+                        }
+                        if constexpr (Rules::alignment) {
+                            alignment_x = alignment_x.add(L::load(&arrays->vx[j]).keep(near));
+                            alignment_y = alignment_y.add(L::load(&arrays->vy[j]).keep(near));
+                        }
+                        counter = counter.add(one.keep(near));
+                    }
+
+                    if constexpr (Rules::separation) {
+                        L close = visible.both(distance_squared.less_equal(separation_limit))
+                                      .both(distance_squared.greater_equal(separation_floor));
+                        L inverse = minus_one.div(distance_squared);
+                        separation_x = separation_x.add(relative_x.mul(inverse).keep(close));
+                        separation_y = separation_y.add(relative_y.mul(inverse).keep(close));
+                    }
+                }
+            }
+
+            finish<Rules>(arrays, grid, params, k, Vec2::build(cohesion_x.sum(), cohesion_y.sum()),
+                          Vec2::build(alignment_x.sum(), alignment_y.sum()),
+                          Vec2::build(separation_x.sum(), separation_y.sum()), counter.sum(), fused);
+        }
+
+        return span * (long long)(end - begin);
+    }
+
+    // one boid's search for its nearest visible boids, see accumulate_nearest
+    template <typename L> struct NearestScan {
+        float x;
+        float y;
+        int self;
+        bool wrap_x;
+        bool wrap_y;
+        bool fold_x;
+        bool fold_y;
+        LaneFold<L> lanes_fold_x;
+        LaneFold<L> lanes_fold_y;
+        L target_x;
+        L target_y;
+        L target_vx;
+        L target_vy;
+        L target_speed;
+        L cone_limit;
+        L minus_one;
+        NearestHeap heap;
+    };
+
+    // offers the boids of cells [first, last] of `row` to the heap. The lanes only pass on visible boids nearer than
+    // the farthest one kept, which are worked out again one at a time with the same arithmetic. Candidates move
+    // along the shift as the reference moves them, unlike in accumulate_cell, so a pick among near ties never
+    // hangs on the last bit; returns the boids looked at
+    template <typename L, typename Rules>
+    static long long scan_run(const BoidArrays *arrays, const SpatialPartition *grid, NearestScan<L> *scan, int row,
+                              int first, int last, float shift_x, float shift_y) {
+        if (first > last) {
+            return 0;
+        }
+        int begin = grid->cell_start[grid->key(first, row)];
+        int end = grid->cell_start[grid->key(last, row) + 1];
+        L shift_lanes_x = L::broadcast(shift_x);
+        L shift_lanes_y = L::broadcast(shift_y);
+        for (int j = begin; j < end; j += L::width) {
+            L relative_x = scan->lanes_fold_x.apply(L::load(&arrays->x[j]).add(shift_lanes_x).sub(scan->target_x));
+            L relative_y = scan->lanes_fold_y.apply(L::load(&arrays->y[j]).add(shift_lanes_y).sub(scan->target_y));
+            L distance_squared = relative_x.mul(relative_x).add(relative_y.mul(relative_y));
+            L wanted = lanes_first<L>(end - j).but_not(lanes_single<L>(scan->self - j));
+            wanted = wanted.both(distance_squared.less_equal(L::broadcast(scan->heap.bound())));
+            if constexpr (Rules::cone) {
+                L facing = scan->target_vx.mul(relative_x).add(scan->target_vy.mul(relative_y));
+                L scale = scan->target_speed.mul(distance_squared.sqrt());
+                L outside = facing.less(scan->cone_limit.mul(scale))
+                                .both(facing.greater_equal(scan->minus_one.mul(scale)));
+                wanted = wanted.but_not(outside);
+            }
+
+            for (uint32_t bits = wanted.lane_bits(); bits != 0; bits &= bits - 1) {
+                int other = j + std::countr_zero(bits);
+                Vec2 relative = Vec2::build(arrays->x[other] + shift_x - scan->x, arrays->y[other] + shift_y - scan->y);
+                if (scan->fold_x) {
+                    relative.x = nearest_offset(relative.x, grid->length_x);
+                }
+                if (scan->fold_y) {
+                    relative.y = nearest_offset(relative.y, grid->length_y);
+                }
+                scan->heap.offer(NearestCandidate{
+                    .distance_squared = relative.x * relative.x + relative.y * relative.y,
+                    .index = grid->indices[other],
+                    .relative = relative,
+                    .velocity = Vec2::build(arrays->vx[other], arrays->vy[other]),
+                });
+            }
+        }
+        return end - begin;
+    }
+
+    // the grid row a row index past either edge comes round to, and the shift that brings its boids along, which a
+    // folded axis leaves to each pair; false where the axis does not wrap
+    template <typename L>
+    static bool row_image(const SpatialPartition *grid, const NearestScan<L> *scan, int index, int *row,
+                          float *shift_y) {
+        *row = index;
+        *shift_y = 0;
+        if (index >= 0 && index < grid->height) {
+            return true;
+        }
+        if (!(scan->wrap_y || scan->fold_y) || index < -grid->height || index >= 2 * grid->height) {
+            return false;
+        }
+        *row = index < 0 ? index + grid->height : index - grid->height;
+        if (scan->wrap_y) {
+            *shift_y = index < 0 ? -grid->length_y : grid->length_y;
+        }
+        return true;
+    }
+
+    // columns [first, last] of a row, which may run past either edge: on a wrapped axis those parts come round from
+    // the far side shifted by the grid's length, on a folded one unshifted and each column once, otherwise they are
+    // cut off
+    template <typename L, typename Rules>
+    static long long scan_row(const BoidArrays *arrays, const SpatialPartition *grid, NearestScan<L> *scan, int row,
+                              int first, int last, float shift_y) {
+        int width = grid->width;
+        float length = scan->wrap_x ? grid->length_x : 0;
+        if (scan->fold_x && last - first + 1 >= width) {
+            first = 0;
+            last = width - 1;
+        }
+        long long pairs = 0;
+        if ((scan->wrap_x || scan->fold_x) && first < 0) {
+            pairs += scan_run<L, Rules>(arrays, grid, scan, row, std::max(first + width, 0),
+                                        std::min(last + width, width - 1), -length, shift_y);
+        }
+        pairs += scan_run<L, Rules>(arrays, grid, scan, row, std::max(first, 0), std::min(last, width - 1), 0, shift_y);
+        if ((scan->wrap_x || scan->fold_x) && last >= width) {
+            pairs += scan_run<L, Rules>(arrays, grid, scan, row, std::max(first - width, 0),
+                                        std::min(last - width, width - 1), length, shift_y);
+        }
+        return pairs;
+    }
+
+    // accumulate_cell for a flock with a nearest cap, on a grid whose cells may be much smaller than the reach. Each
+    // boid first takes squares of cells growing out from its own until it has as many boids as the cap, which at the
+    // cell size BoidManager picks takes a ring or two, then the rows outward from its own for as long as they are
+    // nearer than the farthest boid kept, each only as wide as that distance allows. A boid in a dense flock so looks
+    // at about as many boids as one in a sparse flock; the steering itself is the reference's over the chosen few,
+    // nearest first
+    template <typename L, typename Rules>
+    static long long accumulate_nearest(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params,
+                                        int cell, int begin, int end, const FusedStep *fused) {
+        if (begin == end) {
+            return 0;
+        }
+
+        float neighbor_squared = params->neighbor_distance * params->neighbor_distance;
+        float separation_squared = params->separation_distance * params->separation_distance;
+        float reach_squared = std::max(neighbor_squared, separation_squared);
+        float reach = sqrt(reach_squared);
+        int cell_x = cell % grid->width;
+        int cell_y = cell / grid->width;
+        int rows = (int)ceil(reach / grid->cell_height) + 1;
+
+        // an axis wraps through shifted images where a grid of reach-sized cells would, and folds where that grid
+        // would; a wide row may meet a cell twice under different shifts, but only one image of a boid can be in reach.
+        // It also folds where the window of cells around the boid is too short to tell the images apart: with four
+        // cells round the axis, the cells two away on either side are the same, and either image may be the one in
+        // reach
+        NearestScan<L> scan;
+        scan.fold_x = grid->wrap && (folds_axis(grid->length_x, reach) ||
+                                     blurs_images(grid->width, grid->cell_width, reach));
+        scan.fold_y = grid->wrap && (folds_axis(grid->length_y, reach) ||
+                                     blurs_images(grid->height, grid->cell_height, reach));
+        scan.wrap_x = grid->wrap && !scan.fold_x;
+        scan.wrap_y = grid->wrap && !scan.fold_y;
+        scan.lanes_fold_x = LaneFold<L>::build(scan.fold_x, grid->length_x);
+        scan.lanes_fold_y = LaneFold<L>::build(scan.fold_y, grid->length_y);
+        // a wrapped or folded axis looks no further than the `width` columns and `height` rows centered on the
+        // boid's cell, which hold every boid in reach once; the square grows at most as far, and not at all on a
+        // folded axis, which may have too few cells for even the first ring
+        int up_rows = grid->wrap ? std::min(rows, grid->height / 2) : rows;
+        int down_rows = grid->wrap ? std::min(rows, (grid->height - 1) / 2) : rows;
+        int square_limit = (int)ceil(reach / std::min(grid->cell_width, grid->cell_height));
+        if (grid->wrap) {
+            square_limit = std::min(square_limit, std::min((grid->width - 1) / 2, (grid->height - 1) / 2));
+        }
+        if (scan.fold_x || scan.fold_y) {
+            square_limit = 0;
+        }
+        scan.cone_limit = L::broadcast(cos(params->peripheral_angle));
+        scan.minus_one = L::broadcast(-1);
+
+        long long pairs = 0;
+        for (int k = begin; k < end; k += 1) {
+            scan.x = arrays->x[k];
+            scan.y = arrays->y[k];
+            scan.self = k;
+            scan.target_x = L::broadcast(scan.x);
+            scan.target_y = L::broadcast(scan.y);
+            scan.target_vx = L::broadcast(arrays->vx[k]);
+            scan.target_vy = L::broadcast(arrays->vy[k]);
+            scan.target_speed = L::broadcast(sqrt(arrays->vx[k] * arrays->vx[k] + arrays->vy[k] * arrays->vy[k]));
+            scan.heap = NearestHeap::build(params->nearest_neighbors, reach_squared);
+
+            // the 3x3 square around the boid's cell as three runs, then ring after ring around it until the heap is
+            // full: at the cell size BoidManager picks, that takes the same few rings in a sparse flock as in a dense
+            // one, where rows as wide as the reach would hold ever more cells
+            int square = -1;
+            if (square_limit > 0) {
+                square = 1;
+                for (int dy = -1; dy <= 1; dy += 1) {
+                    int row = 0;
+                    float shift_y = 0;
+                    if (row_image(grid, &scan, cell_y + dy, &row, &shift_y)) {
+                        pairs += scan_row<L, Rules>(arrays, grid, &scan, row, cell_x - 1, cell_x + 1, shift_y);
+                    }
+                }
+            }
+            while (square >= 1 && square < square_limit && scan.heap.count < scan.heap.limit) {
+                square += 1;
+                for (int dy = -square; dy <= square; dy += 1) {
+                    int row = 0;
+                    float shift_y = 0;
+                    if (!row_image(grid, &scan, cell_y + dy, &row, &shift_y)) {
+                        continue;
+                    }
+                    int left = cell_x - square;
+                    int right = cell_x + square;
+                    if (dy == -square || dy == square) {
+                        pairs += scan_row<L, Rules>(arrays, grid, &scan, row, left, right, shift_y);
+                    } else {
+                        pairs += scan_row<L, Rules>(arrays, grid, &scan, row, left, left, shift_y);
+                        pairs += scan_row<L, Rules>(arrays, grid, &scan, row, right, right, shift_y);
+                    }
+                }
+            }
+
+            // then rows in order of distance, 0, -1, 1, -2, 2, ..., each only as wide as the farthest boid kept
+            // allows and without the square, until both sides are past it
+            bool done[2] = {false, false};
+            for (int step = 0; step <= 2 * rows && !(done[0] && done[1]); step += 1) {
+                int side = step % 2;
+                int dy = side == 1 ? -(step + 1) / 2 : step / 2;
+                if (done[side]) {
+                    continue;
+                }
+                int row = 0;
+                float shift_y = 0;
+                if (dy > up_rows || -dy > down_rows || !row_image(grid, &scan, cell_y + dy, &row, &shift_y)) {
+                    done[side] = true;
+                    continue;
+                }
+
+                // the boids off an unwrapped edge are binned into the edge rows, which so have no far side; a folded
+                // row is as near as its nearest image. Cell borders are widened a little, so that the rounding of a
+                // boid into its cell never drops a tie
+                float low = grid->ymin + (cell_y + dy) * grid->cell_height;
+                float high = low + grid->cell_height;
+                if (!grid->wrap && row == 0) {
+                    low = -INFINITY;
+                }
+                if (!grid->wrap && row == grid->height - 1) {
+                    high = INFINITY;
+                }
+                float gap = std::max(std::max(low - scan.y, scan.y - high), 0.0f);
+                for (int image = -1; image <= 1 && scan.fold_y; image += 2) {
+                    float shift = image * grid->length_y;
+                    gap = std::min(gap, std::max(std::max(low + shift - scan.y, scan.y - high - shift), 0.0f));
+                }
+                gap *= 1 - NEAREST_SLACK;
+                float room = scan.heap.bound() - gap * gap;
+                if (room < 0) {
+                    done[side] = dy != 0;
+                    continue;
+                }
+
+                float half = sqrt(room) * (1 + NEAREST_SLACK);
+                int first = (int)floor((scan.x - half - grid->xmin) / grid->cell_width);
+                int last = (int)floor((scan.x + half - grid->xmin) / grid->cell_width);
+                if (!grid->wrap) {
+                    first = std::clamp(first, 0, grid->width - 1);
+                    last = std::clamp(last, 0, grid->width - 1);
+                } else if (scan.wrap_x) {
+                    first = std::max(first, cell_x - (grid->width - 1) / 2);
+                    last = std::min(last, cell_x + grid->width / 2);
+                }
+                if (dy < -square || dy > square) {
+                    pairs += scan_row<L, Rules>(arrays, grid, &scan, row, first, last, shift_y);
+                } else {
+                    pairs += scan_row<L, Rules>(arrays, grid, &scan, row, first, std::min(last, cell_x - square - 1),
+                                                shift_y);
+                    pairs += scan_row<L, Rules>(arrays, grid, &scan, row, std::max(first, cell_x + square + 1), last,
+                                                shift_y);
+                }
+            }
+
+            Vec2 cohesion_force = Vec2::zeros();
+            Vec2 alignment_force = Vec2::zeros();
+            Vec2 separation_force = Vec2::zeros();
+            float neighbors = 0;
+            scan.heap.sort();
+            for (int n = 0; n < scan.heap.count; n += 1) {
+                const NearestCandidate &candidate = scan.heap.items[n];
+                if ((Rules::cohesion || Rules::alignment) && candidate.distance_squared <= neighbor_squared) {
+                    neighbors += 1;
+                    cohesion_force.add_assign(candidate.relative);
+                    alignment_force.add_assign(candidate.velocity);
+                }
+                if (Rules::separation && candidate.distance_squared <= separation_squared &&
+                    candidate.distance_squared >= 1e-8) {
+                    separation_force.add_assign(candidate.relative.mul(-1 / candidate.distance_squared));
+                }
+            }
+            finish<Rules>(arrays, grid, params, k, cohesion_force, alignment_force, separation_force, neighbors, fused);
+        }
+
+        return pairs;
+    }
+
+    // the pairs of the sorted boids [begin, end) of one cell with the boids after them in the cell and with the half
+    // of the stencil ahead of it, the cell to the right and the row above. A pair's offset and distance are worked
+    // out once for both boids, the cone still from either end since one may see the other and not the reverse.
+    // The sums go to the cell's class buffer `sums`, for `reduce` to add up; returns the pairs it looked at
+    template <typename L, typename Rules>
+    static long long accumulate_half(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params,
+                                     int cell, int begin, int end, PairSums *sums) {
+        if (begin == end) {
+            return 0;
+        }
+
+        float neighbor_squared = params->neighbor_distance * params->neighbor_distance;
+        float separation_squared = params->separation_distance * params->separation_distance;
+        float cone = cos(params->peripheral_angle);
+
+        L neighbor_limit = L::broadcast(neighbor_squared);
+        L separation_limit = L::broadcast(separation_squared);
+        L separation_floor = L::broadcast(1e-8);
+        L one = L::broadcast(1);
+        L minus_one = L::broadcast(-1);
+        L cone_limit = L::broadcast(cone);
+        LaneFold<L> fold_x = LaneFold<L>::build(Rules::wrap && grid->fold_x, grid->length_x);
+        LaneFold<L> fold_y = LaneFold<L>::build(Rules::wrap && grid->fold_y, grid->length_y);
+
+        // the rest of the cell first, whose start moves with the boid, then the cell to the right and the row above
+        // in at most two runs each; a wrapped grid has the second span of a run on its last column or row only, and
+        // a folded axis has its few cells all in the plain runs
+        int slices[4][2];
+        float shifts[4][2];
+        int x = cell % grid->width;
+        int y = cell / grid->width;
+        const StencilSpan *columns = &grid->columns[x * 2];
+        const StencilSpan *rows = &grid->rows[y * 2];
+        slices[0][1] = grid->cell_start[cell + 1];
+        shifts[0][0] = 0;
+        shifts[0][1] = 0;
+        int slice_count = 1;
+        const StencilSpan *right = x + 1 < grid->width ? nullptr : &columns[1];
+        if (right == nullptr || right->first <= right->last) {
+            int column = right ? right->first : x + 1;
+            slices[slice_count][0] = grid->cell_start[grid->key(column, y)];
+            slices[slice_count][1] = grid->cell_start[grid->key(column, y) + 1];
+            shifts[slice_count][0] = right ? right->shift : 0;
+            shifts[slice_count][1] = 0;
+            slice_count += 1;
+        }
+        const StencilSpan *above = y + 1 < grid->height ? nullptr : &rows[1];
+        if (above == nullptr || above->first <= above->last) {
+            int row = above ? above->first : y + 1;
+            for (int column = 0; column < 2; column += 1) {
+                if (columns[column].first > columns[column].last) {
+                    continue;
+                }
+                slices[slice_count][0] = grid->cell_start[grid->key(columns[column].first, row)];
+                slices[slice_count][1] = grid->cell_start[grid->key(columns[column].last, row) + 1];
+                shifts[slice_count][0] = columns[column].shift;
+                shifts[slice_count][1] = above ? above->shift : 0;
+                slice_count += 1;
+            }
+        }
+
+        long long pairs = 0;
+        for (int k = begin; k < end; k += 1) {
+            L target_vx = L::broadcast(arrays->vx[k]);
+            L target_vy = L::broadcast(arrays->vy[k]);
+            L target_speed = L::broadcast(arrays->speed[k]);
+
+            L cohesion_x = L::zeros();
+            L cohesion_y = L::zeros();
+            L alignment_x = L::zeros();
+            L alignment_y = L::zeros();
+            L separation_x = L::zeros();
+            L separation_y = L::zeros();
+            L counter = L::zeros();
+
+            slices[0][0] = k + 1;
+            for (int slice = 0; slice < slice_count; slice += 1) {
+                L target_x = L::broadcast(arrays->x[k] - shifts[slice][0]);
+                L target_y = L::broadcast(arrays->y[k] - shifts[slice][1]);
+                int slice_end = slices[slice][1];
+                pairs += slice_end - slices[slice][0];
+                for (int j = slices[slice][0]; j < slice_end; j += L::width) {
+                    // `seen` is k seeing j, `seen_by` j seeing k along the reversed offset
+                    L seen = lanes_first<L>(slice_end - j);
+                    L seen_by = seen;
+
+                    L relative_x = fold_x.apply(L::load(&arrays->x[j]).sub(target_x));
+                    L relative_y = fold_y.apply(L::load(&arrays->y[j]).sub(target_y));
+                    L distance_squared = relative_x.mul(relative_x).add(relative_y.mul(relative_y));
+                    L velocity_x = L::load(&arrays->vx[j]);
+                    L velocity_y = L::load(&arrays->vy[j]);
+                    if constexpr (Rules::cone) {
+                        L distance = distance_squared.sqrt();
+                        L facing = target_vx.mul(relative_x).add(target_vy.mul(relative_y));
+                        L scale = target_speed.mul(distance);
+                        L outside = facing.less(cone_limit.mul(scale)).both(facing.greater_equal(minus_one.mul(scale)));
+                        seen = seen.but_not(outside);
+
+                        L facing_back = L::zeros().sub(velocity_x.mul(relative_x).add(velocity_y.mul(relative_y)));
+                        L scale_back = L::load(&arrays->speed[j]).mul(distance);
+                        L behind = facing_back.less(cone_limit.mul(scale_back))
+                                       .both(facing_back.greater_equal(minus_one.mul(scale_back)));
+                        seen_by = seen_by.but_not(behind);
+                    }
+
+                    if constexpr (Rules::cohesion || Rules::alignment) {
+                        L within = distance_squared.less_equal(neighbor_limit);
+                        L near = seen.both(within);
+                        L near_by = seen_by.both(within);
+                        if constexpr (Rules::cohesion) {
+                            cohesion_x = cohesion_x.add(relative_x.keep(near));
+                            cohesion_y = cohesion_y.add(relative_y.keep(near));
+                            add_lanes(&sums->cohesion_x[j], L::zeros().sub(relative_x).keep(near_by));
+                            add_lanes(&sums->cohesion_y[j], L::zeros().sub(relative_y).keep(near_by));
+                        }
+                        if constexpr (Rules::alignment) {
+                            alignment_x = alignment_x.add(velocity_x.keep(near));
+                            alignment_y = alignment_y.add(velocity_y.keep(near));
+                            add_lanes(&sums->alignment_x[j], target_vx.keep(near_by));
+                            add_lanes(&sums->alignment_y[j], target_vy.keep(near_by));
+                        }
+                        counter = counter.add(one.keep(near));
+                        add_lanes(&sums->neighbors[j], one.keep(near_by));
+                    }
+
+                    if constexpr (Rules::separation) {
+                        L within = distance_squared.less_equal(separation_limit)
+                                       .both(distance_squared.greater_equal(separation_floor));
+                        L inverse = minus_one.div(distance_squared);
+                        L push_x = relative_x.mul(inverse);
+                        L push_y = relative_y.mul(inverse);
+                        separation_x = separation_x.add(push_x.keep(seen.both(within)));
+                        separation_y = separation_y.add(push_y.keep(seen.both(within)));
+                        add_lanes(&sums->separation_x[j], L::zeros().sub(push_x).keep(seen_by.both(within)));
+                        add_lanes(&sums->separation_y[j], L::zeros().sub(push_y).keep(seen_by.both(within)));
+                    }
+                }
+            }
+
+            sums->cohesion_x[k] += cohesion_x.sum();
+            sums->cohesion_y[k] += cohesion_y.sum();
+            sums->alignment_x[k] += alignment_x.sum();
+            sums->alignment_y[k] += alignment_y.sum();
+            sums->separation_x[k] += separation_x.sum();
+            sums->separation_y[k] += separation_y.sum();
+            sums->neighbors[k] += counter.sum();
+        }
+
+        return pairs;
+    }
+
+    // adds `value` into the lanes at `array`; lanes masked out add zero, so the store past a slice's end puts back
+    // what was there
+    template <typename L> static void add_lanes(float *array, L value) {
+        L::load(array).add(value).store(array);
+    }
+
+    // the half-stencil sums of the sorted boids [begin, end) over all `classes` buffers in order, which are left
+    // zeroed, and each boid finished from them
+    template <typename Rules>
+    static void reduce(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params, PairSums *sums,
+                       int classes, int begin, int end, const FusedStep *fused) {
+        for (int k = begin; k < end; k += 1) {
+            Vec2 cohesion_force = Vec2::zeros();
+            Vec2 alignment_force = Vec2::zeros();
+            Vec2 separation_force = Vec2::zeros();
+            float neighbors = 0;
+            for (int group = 0; group < classes; group += 1) {
+                sums[group].take(k, &cohesion_force, &alignment_force, &separation_force, &neighbors);
+            }
+            finish<Rules>(arrays, grid, params, k, cohesion_force, alignment_force, separation_force, neighbors, fused);
+        }
+    }
+
+    // boid k's acceleration from the sums over its neighbors into ax/ay, or with `fused` its next state
+    template <typename Rules>
+    static void finish(BoidArrays *arrays, const SpatialPartition *grid, const BoidParams *params, int k,
+                       Vec2 cohesion_force, Vec2 alignment_force, Vec2 separation_force, float neighbors,
+                       const FusedStep *fused) {
+        Vec2 acceleration = Vec2::zeros();
+        if (neighbors > 0) {
+            acceleration.add_assign(cohesion_force.div(neighbors).mul(params->cohesion));
+            acceleration.add_assign(alignment_force.div(neighbors).mul(params->alignment));
+        }
+        acceleration.add_assign(separation_force.mul(params->separation));
+
+        if (fused != nullptr) {
+            Vec2 position = Vec2::build(arrays->x[k], arrays->y[k]);
+            Boid boid = Boid::build(position, Vec2::build(arrays->vx[k], arrays->vy[k]));
+            advance<Rules::wrap>(&boid, acceleration, fused->bounds, fused->params, fused->delta_time);
+            fused->boids[grid->indices[k]] = boid;
+            return;
+        }
+        arrays->ax[k] = acceleration.x;
+        arrays->ay[k] = acceleration.y;
+    }
+} Kernels;
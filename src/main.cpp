@@ -7,22 +7,63 @@
 #include "../sokol/sokol_log.h"
 
 #include "boids.hpp"
-#include "shaders.hpp"
+#include "checkpoint.hpp"
+#include "render.hpp"
+#include "replay.hpp"
 
-constexpr sg_color BACKGROUND_COLOR = sg_color{.r = 0.15, .g = 0.15, .b = 0.25};
+#define CHECKPOINT_PATH "boids.checkpoint"
+#define REPLAY_SKIP_SECONDS 5
 
 typedef struct State {
-    sg_pass_action pass_action;
-    sg_bindings boid_binding;
-    sg_pipeline boid_pipeline;
-    float frame_time;
+    BoidRenderer renderer;
+    SimulationThread simulation;
 
-    World world;
+    // the render thread's copies, edits are handed to the simulation thread
+    BoidParams params;
+    BoundingBox bounds;
+
+    // `--replay` plays a recording instead, with a playhead in frames
+    ReplayThread replay;
+    bool replaying;
+    bool paused;
+    double playhead;
+    std::chrono::steady_clock::time_point played_at;
+    Snapshot blank;
 
     void update() {
-        this->world.bounds.ymax = sapp_heightf();
-        this->world.bounds.xmax = sapp_widthf();
-        this->world.update(this->frame_time);
+        PROFILE_SCOPE("State::update");
+        if (this->bounds.xmax != sapp_widthf() || this->bounds.ymax != sapp_heightf()) {
+            this->bounds.xmax = sapp_widthf();
+            this->bounds.ymax = sapp_heightf();
+            this->simulation.set_bounds(&this->bounds);
+        }
+    }
+
+    // the playhead moves at the rate the recording was simulated and starts over at the end; like the live view
+    // the frame under it is blended in from the one before, unless the decoder is still behind
+    void play(sg_swapchain swapchain) {
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed = now - this->played_at;
+        this->played_at = now;
+        if (!this->paused) {
+            this->playhead += elapsed.count() * this->replay.frame_rate(this->simulation.steps_per_second);
+        }
+        if (this->playhead >= this->replay.file.frame_count()) {
+            this->seek(0);
+        }
+
+        int index = this->playhead;
+        const ReplaySlot *slot = this->replay.frame(index);
+        if (slot == nullptr) {
+            this->renderer.draw(&this->blank, 1, swapchain);
+            return;
+        }
+        this->renderer.draw(&slot->snapshot, slot->index == index ? this->playhead - index : 1, swapchain);
+    }
+
+    void seek(double playhead) {
+        this->playhead = std::clamp<double>(playhead, 0, this->replay.file.frame_count() - 1);
+        this->replay.seek(this->playhead);
     }
 } State;
 
@@ -34,60 +75,28 @@ void sok_init(void *state_ptr) {
         .environment = sglue_environment(),
     });
 
-    // clang-format off
-    float vertices[] = {
-        -0.4, -0.4,    0.7, 1.0, 0.0,
-         0.4, -0.4,    0.0, 0.7, 1.0,
-         0.0,  1.0,    1.0, 0.0, 0.7,
-    };
-    // clang-format on
-    state->boid_binding.vertex_buffers[0] = sg_make_buffer(sg_buffer_desc{
-        .size = sizeof(vertices),
-        .type = sg_buffer_type::SG_BUFFERTYPE_VERTEXBUFFER,
-        .data = sg_range{.ptr = &vertices, .size = sizeof(vertices)},
-        .label = "boid vertices",
-    });
-
-    sg_pipeline_desc pipeline_desc = sg_pipeline_desc{
-        .shader = sg_make_shader(simple_shader_desc(sg_query_backend())),
-        .label = "boid pipeline",
-    };
-    pipeline_desc.layout.attrs[ATTR_simple_v_pos].format = SG_VERTEXFORMAT_FLOAT2;
-    pipeline_desc.layout.attrs[ATTR_simple_v_color].format = SG_VERTEXFORMAT_FLOAT3;
-    state->boid_pipeline = sg_make_pipeline(pipeline_desc);
-
-    state->pass_action = sg_pass_action{};
-    state->pass_action.colors[0] = sg_color_attachment_action{
-        .load_action = SG_LOADACTION_CLEAR,
-        .clear_value = BACKGROUND_COLOR,
-    };
+    state->renderer.init();
+    if (state->replaying) {
+        state->played_at = std::chrono::steady_clock::now();
+        state->replay.start();
+    } else {
+        state->simulation.start();
+    }
 }
 
 void sok_frame(void *state_ptr) {
     State *state = (State *)state_ptr;
 
-    state->update();
+    if (state->replaying) {
+        PROFILE_SCOPE("sok_frame::play");
+        state->play(sglue_swapchain());
+    } else {
+        state->update();
 
-    sg_begin_pass(sg_pass{
-        .action = state->pass_action,
-        .swapchain = sglue_swapchain(),
-    });
-    sg_apply_pipeline(state->boid_pipeline);
-    sg_apply_bindings(&state->boid_binding);
-    v_params_world_t world = v_params_world_t{
-        .world_dims = {state->world.bounds.xmax, state->world.bounds.ymax},
-    };
-    sg_apply_uniforms(UB_v_params_world, sg_range{.ptr = &world, .size = sizeof(world)});
-    for (Boid &boid : state->world.data.boids) {
-        v_params_boid_t boid_params = v_params_boid_t{
-            .pos = {boid.position.x, boid.position.y},
-            .vel = {boid.velocity.x, boid.velocity.y},
-            .scale = state->world.data.params.boid_scale,
-        };
-        sg_apply_uniforms(UB_v_params_boid, sg_range{.ptr = &boid_params, .size = sizeof(boid_params)});
-        sg_draw(0, state->world.data.params.vertices, 1);
+        PROFILE_SCOPE("sok_frame::draw");
+        const Snapshot *snapshot = state->simulation.snapshots.read();
+        state->renderer.draw(snapshot, state->simulation.alpha(snapshot), sglue_swapchain());
     }
-    sg_end_pass();
     sg_commit();
 }
 
@@ -99,62 +108,105 @@ void sok_event(const sapp_event *event, void *state_ptr) {
             sapp_request_quit();
         }
 
+        // a recording only plays, pauses and seeks; the rest of the keys edit a live simulation
+        if (state->replaying) {
+            double skip = REPLAY_SKIP_SECONDS * state->replay.frame_rate(state->simulation.steps_per_second);
+            if (event->key_code == SAPP_KEYCODE_SPACE) {
+                state->paused = !state->paused;
+            } else if (event->key_code == SAPP_KEYCODE_LEFT) {
+                state->seek(state->playhead - skip);
+            } else if (event->key_code == SAPP_KEYCODE_RIGHT) {
+                state->seek(state->playhead + skip);
+            } else if (event->key_code == SAPP_KEYCODE_HOME) {
+                state->seek(0);
+            }
+            return;
+        }
+
+        if (event->key_code == SAPP_KEYCODE_F5) {
+            state->simulation.request_save(CHECKPOINT_PATH);
+        } else if (event->key_code == SAPP_KEYCODE_F9) {
+            CheckpointFile checkpoint = CheckpointFile::map(CHECKPOINT_PATH);
+            if (checkpoint.valid()) {
+                state->params = checkpoint.header->params;
+                state->params.boid_count = checkpoint.boid_count();
+                state->simulation.request_restore(CHECKPOINT_PATH);
+            } else {
+                printf("cannot restore %s: %s\n", CHECKPOINT_PATH, checkpoint.error);
+            }
+            checkpoint.unmap();
+        }
+
         if (event->key_code == SAPP_KEYCODE_Q) {
-            state->world.data.params.boid_count *= 2;
+            state->params.boid_count *= 2;
         } else if (event->key_code == SAPP_KEYCODE_A) {
-            state->world.data.params.boid_count /= 2;
+            state->params.boid_count /= 2;
         }
-        printf("boid count: %d\n", state->world.data.params.boid_count);
+        printf("boid count: %d\n", state->params.boid_count);
 
         if (event->key_code == SAPP_KEYCODE_W) {
-            state->world.data.params.neighbor_distance *= 2;
+            state->params.neighbor_distance *= 2;
         } else if (event->key_code == SAPP_KEYCODE_S) {
-            state->world.data.params.neighbor_distance /= 2;
+            state->params.neighbor_distance /= 2;
         }
-        printf("neighbor distance: %.2f\n", state->world.data.params.neighbor_distance);
+        printf("neighbor distance: %.2f\n", state->params.neighbor_distance);
 
         if (event->key_code == SAPP_KEYCODE_E) {
-            state->world.data.params.separation_distance *= 2;
+            state->params.separation_distance *= 2;
         } else if (event->key_code == SAPP_KEYCODE_D) {
-            state->world.data.params.separation_distance /= 2;
+            state->params.separation_distance /= 2;
         }
-        printf("separation distance: %.2f\n", state->world.data.params.separation_distance);
+        printf("separation distance: %.2f\n", state->params.separation_distance);
 
         if (event->key_code == SAPP_KEYCODE_R) {
-            state->world.data.params.alignment *= 2;
+            state->params.alignment *= 2;
         } else if (event->key_code == SAPP_KEYCODE_F) {
-            state->world.data.params.alignment /= 2;
+            state->params.alignment /= 2;
         }
-        printf("alignment constant: %.2f\n", state->world.data.params.alignment);
+        printf("alignment constant: %.2f\n", state->params.alignment);
 
         if (event->key_code == SAPP_KEYCODE_T) {
-            state->world.data.params.cohesion *= 2;
+            state->params.cohesion *= 2;
         } else if (event->key_code == SAPP_KEYCODE_G) {
-            state->world.data.params.cohesion /= 2;
+            state->params.cohesion /= 2;
         }
-        printf("cohesion constant: %.2f\n", state->world.data.params.cohesion);
+        printf("cohesion constant: %.2f\n", state->params.cohesion);
 
         if (event->key_code == SAPP_KEYCODE_Y) {
-            state->world.data.params.separation *= 2;
+            state->params.separation *= 2;
         } else if (event->key_code == SAPP_KEYCODE_H) {
-            state->world.data.params.separation /= 2;
+            state->params.separation /= 2;
+        }
+        printf("separation constant: %.2f\n", state->params.separation);
+
+        state->simulation.set_params(&state->params);
+
+#if defined(BOIDS_PROFILE)
+        if (event->key_code == SAPP_KEYCODE_P) {
+            Profiler::global().report(stdout);
         }
-        printf("separation constant: %.2f\n", state->world.data.params.separation);
+#endif
     }
 }
 
 void sok_cleanup(void *user_data) {
     State *state = (State *)user_data;
+    state->simulation.stop();
+    state->replay.stop();
+
+#if defined(BOIDS_PROFILE)
+    Profiler::global().report(stdout);
+    Profiler::global().write_trace("boids_trace.json");
+#endif
 
     sg_shutdown();
     delete state;
 }
 
-sapp_desc sokol_main(int _argc, char *_argv[]) {
+sapp_desc sokol_main(int argc, char *argv[]) {
     State *state_ptr = new State{};
-    state_ptr->frame_time = 0.05;
-    state_ptr->world = World{.bounds = BoundingBox{.xmin = 0, .xmax = 1920, .ymin = 0, .ymax = 1080}};
-    state_ptr->world.data.params = BoidParams{
+    state_ptr->bounds = BoundingBox{.xmin = 0, .xmax = 1920, .ymin = 0, .ymax = 1080};
+    state_ptr->params = BoidParams{
         .vertices = 3,
         .boid_count = 500,
         .max_speed = 200,
@@ -170,14 +222,42 @@ sapp_desc sokol_main(int _argc, char *_argv[]) {
         .wall_strength = 100000,
     };
 
+    SimulationThread &simulation = state_ptr->simulation;
+    simulation.step_time = 0.05;
+    simulation.steps_per_second = 60;
+    simulation.world = World{.bounds = state_ptr->bounds};
+    simulation.world.data.params = state_ptr->params;
+    simulation.world.data.engine = EngineParams{
+        .kernel = KERNEL_SIMD,
+        .threads = (int)std::thread::hardware_concurrency(),
+        .neighbors = NEIGHBORS_AUTO,
+    };
+
+    for (int i = 1; i + 1 < argc; i += 1) {
+        if (strcmp(argv[i], "--replay") == 0) {
+            state_ptr->replaying = state_ptr->replay.open(argv[i + 1]);
+            if (!state_ptr->replaying) {
+                printf("cannot replay %s: %s\n", argv[i + 1], state_ptr->replay.file.error);
+            }
+        }
+    }
+    // the window opens at the size the recording was made at
+    if (state_ptr->replaying) {
+        ReplayThread &replay = state_ptr->replay;
+        replay.threads = std::thread::hardware_concurrency();
+        replay.boid_scale = state_ptr->params.boid_scale;
+        replay.vertices = state_ptr->params.vertices;
+        state_ptr->bounds = replay.file.frames[0].bounds;
+    }
+
     sapp_desc description = sapp_desc{
         .user_data = state_ptr,
         .init_userdata_cb = sok_init,
         .frame_userdata_cb = sok_frame,
         .cleanup_userdata_cb = sok_cleanup,
         .event_userdata_cb = sok_event,
-        .width = (int)state_ptr->world.bounds.xmax,
-        .height = (int)state_ptr->world.bounds.ymax,
+        .width = (int)state_ptr->bounds.xmax,
+        .height = (int)state_ptr->bounds.ymax,
         .sample_count = 4,
         .high_dpi = true,
         .fullscreen = false,
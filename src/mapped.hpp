@@ -0,0 +1,92 @@
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// a whole file mapped read-only; an empty file maps to no memory and is left for the caller to reject
+typedef struct MappedFile {
+    void *memory;
+    uint64_t size;
+    const char *error;
+
+    static MappedFile map(const char *path) {
+        MappedFile file = MappedFile{};
+#if defined(_WIN32)
+        HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                                    nullptr);
+        LARGE_INTEGER length;
+        if (handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(handle, &length)) {
+            if (handle != INVALID_HANDLE_VALUE) {
+                CloseHandle(handle);
+            }
+            file.error = "cannot open file";
+            return file;
+        }
+        file.size = length.QuadPart;
+        // the view keeps the file and its mapping alive once both handles are closed
+        HANDLE mapping = file.size > 0 ? CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(handle);
+        file.memory = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+#else
+        int descriptor = open(path, O_RDONLY);
+        struct stat info;
+        if (descriptor < 0 || fstat(descriptor, &info) != 0) {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+            file.error = "cannot open file";
+            return file;
+        }
+        file.size = info.st_size;
+        file.memory = file.size > 0 ? mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, descriptor, 0) : nullptr;
+        close(descriptor);
+        if (file.memory == MAP_FAILED) {
+            file.memory = nullptr;
+        }
+#endif
+        if (file.memory == nullptr && file.size > 0) {
+            file.error = "cannot map file";
+        }
+        return file;
+    }
+
+    // asks the kernel to start reading the whole file in, for files about to be read end to end
+    void will_need() const {
+#if !defined(_WIN32)
+        if (this->memory) {
+            madvise(this->memory, this->size, MADV_WILLNEED);
+        }
+#endif
+    }
+
+    void unmap() {
+        if (this->memory) {
+#if defined(_WIN32)
+            UnmapViewOfFile(this->memory);
+#else
+            munmap(this->memory, this->size);
+#endif
+        }
+        *this = MappedFile{};
+    }
+} MappedFile;
+
+#endif
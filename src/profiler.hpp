@@ -0,0 +1,157 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// build with -DBOIDS_PROFILE (make PROFILE=1) to enable; otherwise PROFILE_SCOPE expands to nothing
+
+#if defined(BOIDS_PROFILE)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#define PROFILE_EVENTS (1 << 16)
+#define PROFILE_WINDOW 256
+#define PROFILE_PHASES 32
+
+typedef struct ProfileEvent {
+    const char *name;
+    long long start_ns;
+    long long duration_ns;
+    int thread;
+} ProfileEvent;
+
+// the last PROFILE_WINDOW durations of one named scope, for rolling percentiles
+typedef struct ProfilePhase {
+    const char *name;
+    float samples_ms[PROFILE_WINDOW];
+    std::atomic<long long> count;
+
+    void add(float milliseconds) {
+        long long slot = this->count.fetch_add(1);
+        this->samples_ms[slot % PROFILE_WINDOW] = milliseconds;
+    }
+
+    float percentile(float fraction) {
+        int filled = std::min<long long>(this->count.load(), PROFILE_WINDOW);
+        if (filled == 0) {
+            return 0;
+        }
+        float sorted[PROFILE_WINDOW];
+        std::copy(this->samples_ms, this->samples_ms + filled, sorted);
+        int rank = std::min((int)(fraction * filled), filled - 1);
+        std::nth_element(sorted, sorted + rank, sorted + filled);
+        return sorted[rank];
+    }
+} ProfilePhase;
+
+typedef struct Profiler {
+    std::chrono::steady_clock::time_point epoch;
+    ProfileEvent events[PROFILE_EVENTS];
+    std::atomic<long long> event_count;
+    ProfilePhase phases[PROFILE_PHASES];
+    int phase_count;
+    std::mutex lock;
+
+    static Profiler &global() {
+        static Profiler *profiler = new Profiler{.epoch = std::chrono::steady_clock::now()};
+        return *profiler;
+    }
+
+    static int thread_id() {
+        static std::atomic<int> next_thread;
+        thread_local int id = next_thread.fetch_add(1);
+        return id;
+    }
+
+    long long now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->epoch)
+            .count();
+    }
+
+    ProfilePhase *phase(const char *name) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        for (int i = 0; i < this->phase_count; i += 1) {
+            if (strcmp(this->phases[i].name, name) == 0) {
+                return &this->phases[i];
+            }
+        }
+        if (this->phase_count == PROFILE_PHASES) {
+            return &this->phases[PROFILE_PHASES - 1];
+        }
+        this->phases[this->phase_count].name = name;
+        this->phase_count += 1;
+        return &this->phases[this->phase_count - 1];
+    }
+
+    // the event buffer is a ring, a long run keeps its most recent PROFILE_EVENTS scopes
+    void record(ProfilePhase *phase, long long start_ns, long long end_ns) {
+        long long slot = this->event_count.fetch_add(1);
+        this->events[slot % PROFILE_EVENTS] = ProfileEvent{
+            .name = phase->name,
+            .start_ns = start_ns,
+            .duration_ns = end_ns - start_ns,
+            .thread = Profiler::thread_id(),
+        };
+        phase->add((end_ns - start_ns) / 1e6f);
+    }
+
+    // chrome://tracing and ui.perfetto.dev both load this format
+    bool write_trace(const char *path) {
+        FILE *file = fopen(path, "w");
+        if (file == nullptr) {
+            return false;
+        }
+
+        long long count = this->event_count.load();
+        long long first = std::max(count - PROFILE_EVENTS, 0LL);
+        fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+        for (long long i = first; i < count; i += 1) {
+            ProfileEvent &event = this->events[i % PROFILE_EVENTS];
+            fprintf(file, "%s\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                    i == first ? "" : ",", event.name, event.thread, event.start_ns / 1e3, event.duration_ns / 1e3);
+        }
+        fprintf(file, "\n]}\n");
+        fclose(file);
+        return true;
+    }
+
+    void report(FILE *file) {
+        fprintf(file, "%-24s %10s %10s %10s\n", "phase", "calls", "p50 ms", "p99 ms");
+        for (int i = 0; i < this->phase_count; i += 1) {
+            ProfilePhase &phase = this->phases[i];
+            fprintf(file, "%-24s %10lld %10.3f %10.3f\n", phase.name, phase.count.load(), phase.percentile(0.5),
+                    phase.percentile(0.99));
+        }
+    }
+} Profiler;
+
+typedef struct ProfileScope {
+    ProfilePhase *phase;
+    long long start_ns;
+
+    ProfileScope(ProfilePhase *phase) : phase(phase), start_ns(Profiler::global().now_ns()) {
+    }
+
+    ~ProfileScope() {
+        Profiler &profiler = Profiler::global();
+        profiler.record(this->phase, this->start_ns, profiler.now_ns());
+    }
+} ProfileScope;
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name)                                                                                            \
+    static ProfilePhase *PROFILE_CONCAT(profile_phase_, __LINE__) = Profiler::global().phase(name);                   \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_phase_, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif
+
+#endif
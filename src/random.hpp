@@ -0,0 +1,40 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+#define SPLITMIX_GAMMA 0x9e3779b97f4a7c15ull
+
+// splitmix64: a counter stepped by the golden ratio and run through a strong mixer. The same seed gives the same
+// numbers on every platform, unlike rand()
+typedef struct Random {
+    uint64_t state;
+
+    static Random build(uint64_t seed) {
+        return Random{.state = seed};
+    }
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t next() {
+        this->state += SPLITMIX_GAMMA;
+        return mix(this->state);
+    }
+
+    // a generator of its own for item `index`, seeded from this one without advancing it, so item n draws the same
+    // numbers however many items were split off before it and in whatever order
+    Random split(uint64_t index) const {
+        return Random{.state = mix(this->state + (index + 1) * SPLITMIX_GAMMA)};
+    }
+
+    // uniform in [0, 1), from the top 24 bits
+    float unit() {
+        return (this->next() >> 40) * 0x1.0p-24f;
+    }
+} Random;
+
+#endif
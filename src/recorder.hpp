@@ -0,0 +1,615 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "boids.hpp"
+
+#define TRAJECTORY_MAGIC "CBOIDSTR"
+#define TRAJECTORY_VERSION 2
+#define TRAJECTORY_BYTE_ORDER 0x01020304u
+#define TRAJECTORY_KEYFRAME 1u
+#define TRAJECTORY_LINEAR 2u
+#define TRAJECTORY_WRAPPED 4u
+#define TRAJECTORY_STREAMS 4
+#define RECORDER_SLOTS 4
+#define RECORDER_CHUNK_BYTES (1 << 20)
+// values are rice coded in blocks, each with its own parameter; a quotient this long is escaped to 32 raw bits
+#define RICE_BLOCK 64
+#define RICE_ESCAPE 24
+
+// a trajectory file is this header and then frames, each a TrajectoryFrame and `payload_bytes` of coded streams.
+// The payload opens with the byte length of each stream, so the streams can be decoded side by side
+typedef struct TrajectoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t frame_header_size;
+    uint32_t position_bits;
+    uint32_t velocity_bits;
+    uint32_t decimation;
+    uint32_t keyframe_interval;
+    uint32_t reserved;
+} TrajectoryHeader;
+
+// boids are stored by a stable id that survives morton reorders. Keyframes code the quantized x, y, vx, vy
+// streams as they are, other frames code how far each value missed its prediction from the frames before: the
+// last value, or with TRAJECTORY_LINEAR a straight line through the last two, which leaves little more than
+// the acceleration to code for positions. TRAJECTORY_WRAPPED marks a flock on a torus
+typedef struct TrajectoryFrame {
+    uint64_t payload_bytes;
+    int64_t step;
+    int32_t count;
+    uint32_t flags;
+    BoundingBox bounds;
+    float speed_range;
+    uint32_t reserved;
+} TrajectoryFrame;
+
+// maps [low, low + range] onto [0, scale]; anything outside, nan included, is clamped
+static uint32_t quantize(float value, float low, float range, uint32_t scale) {
+    float unit = (value - low) / range;
+    if (!(unit > 0)) {
+        return 0;
+    }
+    if (unit >= 1) {
+        return scale;
+    }
+    return (uint32_t)(unit * scale + 0.5f);
+}
+
+static float dequantize(uint32_t value, float low, float range, uint32_t scale) {
+    return low + range * value / scale;
+}
+
+static uint32_t predict(const uint32_t *previous, const uint32_t *earlier, int i, bool linear) {
+    return linear ? 2 * previous[i] - earlier[i] : previous[i];
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// least significant bit first
+typedef struct BitWriter {
+    std::vector<uint8_t> *bytes;
+    uint64_t pending;
+    int count;
+
+    void put(uint32_t value, int bits) {
+        this->pending |= (uint64_t)value << this->count;
+        this->count += bits;
+        while (this->count >= 8) {
+            this->bytes->push_back(this->pending & 0xff);
+            this->pending >>= 8;
+            this->count -= 8;
+        }
+    }
+
+    void flush() {
+        if (this->count > 0) {
+            this->bytes->push_back(this->pending & 0xff);
+        }
+        this->pending = 0;
+        this->count = 0;
+    }
+} BitWriter;
+
+// reads past the end come back as zeros and leave `overrun()` true
+typedef struct BitReader {
+    const uint8_t *bytes;
+    uint64_t size;
+    uint64_t next;
+    uint64_t pending;
+    int count;
+
+    // tops `pending` up to at least 57 bits, which covers any single read. Away from the end a little endian
+    // machine loads a whole word; the bits past `count` it leaves behind are the same ones the next load brings
+    void refill() {
+        if (std::endian::native == std::endian::little && this->next + 8 <= this->size) {
+            uint64_t word;
+            memcpy(&word, this->bytes + this->next, sizeof(word));
+            this->pending |= word << this->count;
+            int taken = (64 - this->count) / 8;
+            this->next += taken;
+            this->count += taken * 8;
+            return;
+        }
+        while (this->count <= 56) {
+            uint64_t byte = this->next < this->size ? this->bytes[this->next] : 0;
+            this->next += 1;
+            this->pending |= byte << this->count;
+            this->count += 8;
+        }
+    }
+
+    uint32_t take(int bits) {
+        if (this->count < bits) {
+            this->refill();
+        }
+        uint32_t value = bits == 32 ? (uint32_t)this->pending : (uint32_t)(this->pending & ((1ull << bits) - 1));
+        this->pending >>= bits;
+        this->count -= bits;
+        return value;
+    }
+
+    bool overrun() const {
+        return this->next * 8 - this->count > this->size * 8;
+    }
+} BitReader;
+
+// a parameter near log2 of half the block mean, which is close to optimal for the geometric spread of deltas
+static void rice_encode(const uint32_t *values, int count, BitWriter *writer) {
+    for (int begin = 0; begin < count; begin += RICE_BLOCK) {
+        int end = std::min(begin + RICE_BLOCK, count);
+        uint64_t sum = 0;
+        for (int i = begin; i < end; i += 1) {
+            sum += values[i];
+        }
+        int k = 0;
+        while (k < 31 && ((uint64_t)(end - begin) << (k + 1)) <= sum) {
+            k += 1;
+        }
+        writer->put(k, 5);
+        for (int i = begin; i < end; i += 1) {
+            uint32_t quotient = values[i] >> k;
+            if (quotient >= RICE_ESCAPE) {
+                writer->put((1u << RICE_ESCAPE) - 1, RICE_ESCAPE);
+                writer->put(values[i], 32);
+                continue;
+            }
+            writer->put((1u << quotient) - 1, quotient + 1);
+            if (k > 0) {
+                writer->put(values[i] & ((1u << k) - 1), k);
+            }
+        }
+    }
+}
+
+// works on a local copy of the reader, the stores to `values` could otherwise alias its counters
+static void rice_decode(BitReader *source, uint32_t *values, int count) {
+    BitReader reader = *source;
+    for (int begin = 0; begin < count; begin += RICE_BLOCK) {
+        int end = std::min(begin + RICE_BLOCK, count);
+        int k = reader.take(5);
+        uint64_t mask = (1ull << k) - 1;
+        for (int i = begin; i < end; i += 1) {
+            // one refill covers the longest quotient, its stop bit and the remainder
+            if (reader.count < RICE_ESCAPE + 1 + k) {
+                reader.refill();
+            }
+            uint32_t quotient = std::min<uint32_t>(std::countr_one(reader.pending), RICE_ESCAPE);
+            if (quotient == RICE_ESCAPE) {
+                reader.pending >>= RICE_ESCAPE;
+                reader.count -= RICE_ESCAPE;
+                values[i] = reader.take(32);
+                continue;
+            }
+            values[i] = (quotient << k) | (uint32_t)((reader.pending >> (quotient + 1)) & mask);
+            reader.pending >>= quotient + 1 + k;
+            reader.count -= quotient + 1 + k;
+        }
+    }
+    *source = reader;
+}
+
+// the quantized streams of the last two frames, which the next frame's predictions come from
+typedef struct TrajectoryDecoder {
+    std::vector<uint32_t> streams[TRAJECTORY_STREAMS];
+    std::vector<uint32_t> earlier[TRAJECTORY_STREAMS];
+    std::vector<uint32_t> values[TRAJECTORY_STREAMS];
+    int count;
+    int history;
+
+    // writes boid `id` of the frame to positions[id] and velocities[id], or only advances the streams when they
+    // are null; false for a delta frame without the frames before it, or a payload that ends early. With a pool
+    // the streams are decoded side by side
+    bool decode(const TrajectoryHeader *file, const TrajectoryFrame *frame, const uint8_t *payload, Vec2 *positions,
+                Vec2 *velocities, ThreadPool *pool = nullptr) {
+        bool key = frame->flags & TRAJECTORY_KEYFRAME;
+        bool linear = frame->flags & TRAJECTORY_LINEAR;
+        int count = frame->count;
+        if (!key && (count != this->count || this->history < (linear ? 2 : 1))) {
+            return false;
+        }
+        uint32_t lengths[TRAJECTORY_STREAMS];
+        uint64_t offsets[TRAJECTORY_STREAMS];
+        uint64_t offset = sizeof(lengths);
+        if (frame->payload_bytes < offset) {
+            this->count = -1;
+            return false;
+        }
+        memcpy(lengths, payload, sizeof(lengths));
+        for (int s = 0; s < TRAJECTORY_STREAMS; s += 1) {
+            offsets[s] = offset;
+            offset += lengths[s];
+        }
+        if (offset > frame->payload_bytes) {
+            this->count = -1;
+            return false;
+        }
+
+        bool overrun[TRAJECTORY_STREAMS];
+        auto decode_streams = [&](int begin, int end) {
+            for (int s = begin; s < end; s += 1) {
+                BitReader reader = BitReader{.bytes = payload + offsets[s], .size = lengths[s]};
+                this->values[s].resize(count);
+                uint32_t *values = this->values[s].data();
+                const uint32_t *previous = this->streams[s].data();
+                const uint32_t *earlier = this->earlier[s].data();
+                rice_decode(&reader, values, count);
+                for (int i = 0; i < count && !key; i += 1) {
+                    values[i] = predict(previous, earlier, i, linear) + unzigzag(values[i]);
+                }
+                this->earlier[s].swap(this->streams[s]);
+                this->streams[s].swap(this->values[s]);
+                overrun[s] = reader.overrun();
+            }
+        };
+        if (pool != nullptr) {
+            pool->parallel_for(TRAJECTORY_STREAMS, decode_streams);
+        } else {
+            decode_streams(0, TRAJECTORY_STREAMS);
+        }
+        this->count = count;
+        this->history = key ? 1 : this->history + 1;
+        for (int s = 0; s < TRAJECTORY_STREAMS; s += 1) {
+            if (overrun[s]) {
+                this->count = -1;
+                return false;
+            }
+        }
+        if (positions == nullptr) {
+            return true;
+        }
+
+        uint32_t position_scale = (1u << file->position_bits) - 1;
+        uint32_t velocity_scale = (1u << file->velocity_bits) - 1;
+        const BoundingBox &bounds = frame->bounds;
+        float speed = frame->speed_range;
+        auto unpack = [&](int begin, int end) {
+            for (int i = begin; i < end; i += 1) {
+                float x = dequantize(this->streams[0][i], bounds.xmin, bounds.width(), position_scale);
+                float y = dequantize(this->streams[1][i], bounds.ymin, bounds.height(), position_scale);
+                positions[i] = Vec2::build(x, y);
+                velocities[i] = Vec2::build(dequantize(this->streams[2][i], -speed, 2 * speed, velocity_scale),
+                                            dequantize(this->streams[3][i], -speed, 2 * speed, velocity_scale));
+            }
+        };
+        if (pool != nullptr) {
+            pool->parallel_for(count, unpack);
+        } else {
+            unpack(0, count);
+        }
+        return true;
+    }
+} TrajectoryDecoder;
+
+typedef struct RecorderOptions {
+    int decimation;
+    int keyframe_interval;
+    int position_bits;
+    int velocity_bits;
+} RecorderOptions;
+
+// one step as the sim thread left it; `origin[k]` is where boid k sat in the previous recorded frame when the
+// flock was reordered in between
+typedef struct RecorderSlot {
+    std::vector<Boid> boids;
+    std::vector<int> origin;
+    BoundingBox bounds;
+    float speed_range;
+    long long step;
+    bool permuted;
+    bool reset;
+    bool wrap;
+} RecorderSlot;
+
+// the sim thread copies every `decimation`th step into a ring slot and moves on; a background thread quantizes,
+// delta codes and rice codes the slots and writes them out in chunks. A full ring drops the step rather than
+// stall the simulation
+typedef struct TrajectoryRecorder {
+    RecorderOptions options;
+    FILE *file;
+    RecorderSlot slots[RECORDER_SLOTS];
+    long long head;
+    long long tail;
+    std::mutex lock;
+    std::condition_variable ready;
+    bool stopping;
+    std::thread thread;
+
+    // sim thread: reorders and resizes seen since the last slot went out
+    std::vector<int> origin;
+    std::vector<int> composed;
+    bool permuted;
+    bool reset;
+    int last_count;
+    long long calls;
+
+    // encoder thread
+    std::vector<int> ids;
+    std::vector<int> next_ids;
+    std::vector<uint32_t> quantized[TRAJECTORY_STREAMS];
+    std::vector<uint32_t> previous[TRAJECTORY_STREAMS];
+    std::vector<uint32_t> earlier[TRAJECTORY_STREAMS];
+    std::vector<uint32_t> coded;
+    std::vector<uint8_t> chunk;
+    TrajectoryFrame last_frame;
+    int since_keyframe;
+    int history;
+
+    // counters, read once the recorder has stopped
+    long long recorded;
+    long long dropped;
+    long long keyframes;
+    double record_ns;
+    double record_max_ns;
+    double encode_ns;
+    long long raw_bytes;
+    long long written_bytes;
+    bool failed;
+
+    ~TrajectoryRecorder() {
+        this->stop();
+    }
+
+    bool start(const char *path, const RecorderOptions *options) {
+        this->options = *options;
+        this->options.decimation = std::max(this->options.decimation, 1);
+        this->options.keyframe_interval = std::max(this->options.keyframe_interval, 1);
+        this->options.position_bits = std::clamp(this->options.position_bits, 1, 24);
+        this->options.velocity_bits = std::clamp(this->options.velocity_bits, 1, 24);
+        this->file = fopen(path, "wb");
+        if (this->file == nullptr) {
+            return false;
+        }
+
+        TrajectoryHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic));
+        header.version = TRAJECTORY_VERSION;
+        header.byte_order = TRAJECTORY_BYTE_ORDER;
+        header.frame_header_size = sizeof(TrajectoryFrame);
+        header.position_bits = this->options.position_bits;
+        header.velocity_bits = this->options.velocity_bits;
+        header.decimation = this->options.decimation;
+        header.keyframe_interval = this->options.keyframe_interval;
+        this->chunk.insert(this->chunk.end(), (const uint8_t *)&header, (const uint8_t *)(&header + 1));
+
+        this->last_count = -1;
+        this->stopping = false;
+        this->thread = std::thread(&TrajectoryRecorder::encode_loop, this);
+        return true;
+    }
+
+    // sim thread, once after every step; only a recorded step pays for more than bookkeeping
+    void record(const World *world, long long step) {
+        auto started = std::chrono::steady_clock::now();
+        const BoidManager &data = world->data;
+        int count = data.boids.size();
+        if (count != this->last_count) {
+            this->last_count = count;
+            this->reset = true;
+        }
+        if (data.reordered && !this->reset) {
+            this->compose(data.order);
+        }
+        this->calls += 1;
+        if ((this->calls - 1) % this->options.decimation != 0) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if (this->head - this->tail == RECORDER_SLOTS) {
+                this->dropped += 1;
+                return;
+            }
+        }
+        RecorderSlot &slot = this->slots[this->head % RECORDER_SLOTS];
+        slot.boids.resize(count);
+        memcpy(slot.boids.data(), data.boids.data(), count * sizeof(Boid));
+        slot.bounds = world->bounds;
+        slot.speed_range = data.params.max_speed;
+        slot.step = step;
+        slot.wrap = data.engine.boundary == BOUNDARY_TORUS;
+        slot.reset = this->reset;
+        slot.permuted = this->permuted && !this->reset;
+        if (slot.permuted) {
+            slot.origin.swap(this->origin);
+        }
+        this->reset = false;
+        this->permuted = false;
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->head += 1;
+        }
+
+        // timed before the wakeup, on a single core the encoder would otherwise run inside this interval
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+        this->recorded += 1;
+        this->record_ns += ns;
+        this->record_max_ns = std::max(this->record_max_ns, ns);
+        this->ready.notify_one();
+    }
+
+    // `order[new] = old` for this step's reorder, folded into the mapping back to the last recorded frame
+    void compose(const std::vector<int> &order) {
+        int count = order.size();
+        if (!this->permuted || (int)this->origin.size() != count) {
+            this->origin.assign(order.begin(), order.end());
+            this->permuted = true;
+            return;
+        }
+        this->composed.resize(count);
+        for (int k = 0; k < count; k += 1) {
+            this->composed[k] = this->origin[order[k]];
+        }
+        this->origin.swap(this->composed);
+    }
+
+    // drains whatever is still queued, then writes the last chunk
+    void stop() {
+        if (!this->thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->stopping = true;
+        }
+        this->ready.notify_one();
+        this->thread.join();
+        this->write_chunk();
+        this->failed = fclose(this->file) != 0 || this->failed;
+        this->file = nullptr;
+    }
+
+    void encode_loop() {
+        while (true) {
+            RecorderSlot *slot;
+            {
+                std::unique_lock<std::mutex> guard(this->lock);
+                this->ready.wait(guard, [this]() { return this->stopping || this->tail < this->head; });
+                if (this->tail == this->head) {
+                    return;
+                }
+                slot = &this->slots[this->tail % RECORDER_SLOTS];
+            }
+
+            auto started = std::chrono::steady_clock::now();
+            this->encode(slot);
+            if (this->chunk.size() >= RECORDER_CHUNK_BYTES) {
+                this->write_chunk();
+            }
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            this->encode_ns += std::chrono::duration<double, std::nano>(elapsed).count();
+
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->tail += 1;
+        }
+    }
+
+    void encode(const RecorderSlot *slot) {
+        int count = slot->boids.size();
+        TrajectoryFrame frame = TrajectoryFrame{
+            .step = slot->step,
+            .count = count,
+            .bounds = slot->bounds,
+            .speed_range = slot->speed_range,
+        };
+
+        // ids follow boids through reorders, a resize starts the numbering over
+        if (slot->reset || (int)this->ids.size() != count) {
+            this->ids.resize(count);
+            for (int k = 0; k < count; k += 1) {
+                this->ids[k] = k;
+            }
+        } else if (slot->permuted) {
+            this->next_ids.resize(count);
+            for (int k = 0; k < count; k += 1) {
+                this->next_ids[k] = this->ids[slot->origin[k]];
+            }
+            this->ids.swap(this->next_ids);
+        }
+
+        // deltas only make sense in the same units over the same boids
+        bool key = slot->reset || this->since_keyframe == 0 || count != this->last_frame.count ||
+                   memcmp(&frame.bounds, &this->last_frame.bounds, sizeof(BoundingBox)) != 0 ||
+                   frame.speed_range != this->last_frame.speed_range;
+        if (key) {
+            frame.flags |= TRAJECTORY_KEYFRAME;
+            this->since_keyframe = 0;
+            this->keyframes += 1;
+            this->history = 0;
+        }
+        bool linear = this->history >= 2;
+        if (linear) {
+            frame.flags |= TRAJECTORY_LINEAR;
+        }
+        if (slot->wrap) {
+            frame.flags |= TRAJECTORY_WRAPPED;
+        }
+        this->since_keyframe = (this->since_keyframe + 1) % this->options.keyframe_interval;
+
+        uint32_t position_scale = (1u << this->options.position_bits) - 1;
+        uint32_t velocity_scale = (1u << this->options.velocity_bits) - 1;
+        const BoundingBox &bounds = frame.bounds;
+        float speed = frame.speed_range;
+        for (int s = 0; s < TRAJECTORY_STREAMS; s += 1) {
+            this->quantized[s].resize(count);
+        }
+        for (int k = 0; k < count; k += 1) {
+            const Boid &boid = slot->boids[k];
+            int id = this->ids[k];
+            this->quantized[0][id] = quantize(boid.position.x, bounds.xmin, bounds.width(), position_scale);
+            this->quantized[1][id] = quantize(boid.position.y, bounds.ymin, bounds.height(), position_scale);
+            this->quantized[2][id] = quantize(boid.velocity.x, -speed, 2 * speed, velocity_scale);
+            this->quantized[3][id] = quantize(boid.velocity.y, -speed, 2 * speed, velocity_scale);
+        }
+
+        size_t frame_at = this->chunk.size();
+        size_t lengths_at = frame_at + sizeof(TrajectoryFrame);
+        this->chunk.resize(lengths_at + TRAJECTORY_STREAMS * sizeof(uint32_t));
+        BitWriter writer = BitWriter{.bytes = &this->chunk};
+        this->coded.resize(count);
+        for (int s = 0; s < TRAJECTORY_STREAMS; s += 1) {
+            size_t stream_at = this->chunk.size();
+            const uint32_t *previous = this->previous[s].data();
+            const uint32_t *earlier = this->earlier[s].data();
+            for (int i = 0; i < count; i += 1) {
+                uint32_t value = this->quantized[s][i];
+                this->coded[i] = key ? value : zigzag(value - predict(previous, earlier, i, linear));
+            }
+            rice_encode(this->coded.data(), count, &writer);
+            writer.flush();
+            uint32_t length = this->chunk.size() - stream_at;
+            memcpy(this->chunk.data() + lengths_at + s * sizeof(uint32_t), &length, sizeof(length));
+            this->earlier[s].swap(this->previous[s]);
+            this->previous[s].swap(this->quantized[s]);
+        }
+        this->history += 1;
+
+        frame.payload_bytes = this->chunk.size() - frame_at - sizeof(TrajectoryFrame);
+        memcpy(this->chunk.data() + frame_at, &frame, sizeof(frame));
+        this->last_frame = frame;
+        this->raw_bytes += (long long)count * 4 * sizeof(float);
+    }
+
+    void write_chunk() {
+        if (!this->chunk.empty()) {
+            this->failed = fwrite(this->chunk.data(), 1, this->chunk.size(), this->file) != this->chunk.size() ||
+                           this->failed;
+            this->written_bytes += this->chunk.size();
+            this->chunk.clear();
+        }
+    }
+
+    // sim thread cost is what recording adds to a step; the encoder runs beside it
+    void report(FILE *out) const {
+        double frames = std::max(this->recorded, 1LL);
+        fprintf(out, "recorder: %lld frames (every %d steps), %lld keyframes, %lld dropped\n", this->recorded,
+                this->options.decimation, this->keyframes, this->dropped);
+        fprintf(out, "  sim thread: %.3f ms/frame mean, %.3f ms max\n", this->record_ns / frames / 1e6,
+                this->record_max_ns / 1e6);
+        fprintf(out, "  encoder: %.3f ms/frame, %lld bytes written, %.2fx smaller than raw floats%s\n",
+                this->encode_ns / frames / 1e6, this->written_bytes,
+                this->written_bytes > 0 ? (double)this->raw_bytes / this->written_bytes : 0.0,
+                this->failed ? ", WRITE FAILED" : "");
+    }
+} TrajectoryRecorder;
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <algorithm>
+#include <vector>
+
+#include "../sokol/sokol_gfx.h"
+
+#include "shaders.hpp"
+#include "simulation.hpp"
+
+#define INSTANCE_BUFFER_SLOT 1
+#define MIN_INSTANCE_CAPACITY 1024
+
+constexpr sg_color BACKGROUND_COLOR = sg_color{.r = 0.15, .g = 0.15, .b = 0.25};
+
+// one boid in the per-instance vertex buffer, laid out like the i_pos/i_vel/i_scale inputs of simple_vs
+typedef struct BoidInstance {
+    float pos[2];
+    float vel[2];
+    float scale;
+} BoidInstance;
+
+// draws the whole flock with a single instanced sg_draw, the instance buffer is rewritten once per frame
+typedef struct BoidRenderer {
+    sg_pass_action pass_action;
+    sg_bindings binding;
+    sg_pipeline pipeline;
+    std::vector<BoidInstance> instances;
+    int capacity;
+
+    void init() {
+        // clang-format off
+        float vertices[] = {
+            -0.4, -0.4,    0.7, 1.0, 0.0,
+             0.4, -0.4,    0.0, 0.7, 1.0,
+             0.0,  1.0,    1.0, 0.0, 0.7,
+        };
+        // clang-format on
+        this->binding.vertex_buffers[0] = sg_make_buffer(sg_buffer_desc{
+            .size = sizeof(vertices),
+            .type = sg_buffer_type::SG_BUFFERTYPE_VERTEXBUFFER,
+            .data = sg_range{.ptr = &vertices, .size = sizeof(vertices)},
+            .label = "boid vertices",
+        });
+        this->reserve(MIN_INSTANCE_CAPACITY);
+
+        // sokol-shdc has no dummy variant, and the dummy backend compiles nothing, so any desc with our layout will do
+        sg_backend backend = sg_query_backend() == SG_BACKEND_DUMMY ? SG_BACKEND_GLCORE : sg_query_backend();
+        sg_pipeline_desc pipeline_desc = sg_pipeline_desc{
+            .shader = sg_make_shader(simple_shader_desc(backend)),
+            .label = "boid pipeline",
+        };
+        pipeline_desc.layout.buffers[INSTANCE_BUFFER_SLOT].step_func = SG_VERTEXSTEP_PER_INSTANCE;
+        pipeline_desc.layout.attrs[ATTR_simple_v_pos].format = SG_VERTEXFORMAT_FLOAT2;
+        pipeline_desc.layout.attrs[ATTR_simple_v_color].format = SG_VERTEXFORMAT_FLOAT3;
+        pipeline_desc.layout.attrs[ATTR_simple_i_pos].buffer_index = INSTANCE_BUFFER_SLOT;
+        pipeline_desc.layout.attrs[ATTR_simple_i_pos].format = SG_VERTEXFORMAT_FLOAT2;
+        pipeline_desc.layout.attrs[ATTR_simple_i_vel].buffer_index = INSTANCE_BUFFER_SLOT;
+        pipeline_desc.layout.attrs[ATTR_simple_i_vel].format = SG_VERTEXFORMAT_FLOAT2;
+        pipeline_desc.layout.attrs[ATTR_simple_i_scale].buffer_index = INSTANCE_BUFFER_SLOT;
+        pipeline_desc.layout.attrs[ATTR_simple_i_scale].format = SG_VERTEXFORMAT_FLOAT;
+        this->pipeline = sg_make_pipeline(pipeline_desc);
+
+        this->pass_action = sg_pass_action{};
+        this->pass_action.colors[0] = sg_color_attachment_action{
+            .load_action = SG_LOADACTION_CLEAR,
+            .clear_value = BACKGROUND_COLOR,
+        };
+    }
+
+    // stream buffers cannot grow, so a bigger flock gets a fresh buffer with some headroom
+    void reserve(int count) {
+        if (count <= this->capacity) {
+            return;
+        }
+        if (this->capacity > 0) {
+            sg_destroy_buffer(this->binding.vertex_buffers[INSTANCE_BUFFER_SLOT]);
+        }
+        this->capacity = std::max({count, this->capacity * 2, MIN_INSTANCE_CAPACITY});
+        this->binding.vertex_buffers[INSTANCE_BUFFER_SLOT] = sg_make_buffer(sg_buffer_desc{
+            .size = this->capacity * sizeof(BoidInstance),
+            .type = sg_buffer_type::SG_BUFFERTYPE_VERTEXBUFFER,
+            .usage = SG_USAGE_STREAM,
+            .label = "boid instances",
+        });
+    }
+
+    void fill(const Snapshot *snapshot, float alpha) {
+        int count = snapshot->positions.size();
+        this->instances.resize(count);
+        for (int i = 0; i < count; i += 1) {
+            Vec2 position = snapshot->position(i, alpha);
+            this->instances[i] = BoidInstance{
+                .pos = {position.x, position.y},
+                .vel = {snapshot->velocities[i].x, snapshot->velocities[i].y},
+                .scale = snapshot->boid_scale,
+            };
+        }
+    }
+
+    // `alpha` blends each boid from its previous position (0) to its newest one (1)
+    void draw(const Snapshot *snapshot, float alpha, sg_swapchain swapchain) {
+        this->fill(snapshot, alpha);
+        int count = this->instances.size();
+        this->reserve(count);
+
+        sg_begin_pass(sg_pass{
+            .action = this->pass_action,
+            .swapchain = swapchain,
+        });
+        if (count > 0) {
+            sg_update_buffer(this->binding.vertex_buffers[INSTANCE_BUFFER_SLOT],
+                             sg_range{.ptr = this->instances.data(), .size = count * sizeof(BoidInstance)});
+            sg_apply_pipeline(this->pipeline);
+            sg_apply_bindings(&this->binding);
+            v_params_world_t world_params = v_params_world_t{
+                .world_dims = {snapshot->bounds.xmax, snapshot->bounds.ymax},
+            };
+            sg_apply_uniforms(UB_v_params_world, sg_range{.ptr = &world_params, .size = sizeof(world_params)});
+            sg_draw(0, snapshot->vertices, count);
+        }
+        sg_end_pass();
+    }
+} BoidRenderer;
+
+#endif
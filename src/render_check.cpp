@@ -0,0 +1,87 @@
+#define SOKOL_IMPL
+#define SOKOL_DUMMY_BACKEND
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "../sokol/sokol_gfx.h"
+#include "../sokol/sokol_log.h"
+
+#include "render.hpp"
+
+#define CHECK_FRAMES 8
+
+// renders a flock through the dummy backend and fails unless every frame is one draw, one upload, one buffer update
+int main(int argc, char *argv[]) {
+    int boid_count = argc > 1 ? atoi(argv[1]) : 100000;
+
+    sg_environment environment = sg_environment{
+        .defaults =
+            sg_environment_defaults{
+                .color_format = SG_PIXELFORMAT_RGBA8,
+                .depth_format = SG_PIXELFORMAT_DEPTH_STENCIL,
+                .sample_count = 1,
+            },
+    };
+    sg_setup(sg_desc{
+        .logger = sg_logger{.func = slog_func},
+        .environment = environment,
+    });
+    sg_enable_frame_stats();
+
+    World world = World{.bounds = BoundingBox{.xmin = 0, .xmax = 1920, .ymin = 0, .ymax = 1080}};
+    world.data.params = BoidParams{
+        .vertices = 3,
+        .boid_count = boid_count,
+        .max_speed = 200,
+        .min_speed = 75,
+        .boid_scale = 10,
+        .neighbor_distance = 200,
+        .separation_distance = 50,
+        .cohesion = 0.625,
+        .alignment = 2.5,
+        .separation = 1000,
+        .peripheral_angle = PI / 6,
+        .wall_distance = 300,
+        .wall_strength = 100000,
+    };
+    world.data.engine = EngineParams{
+        .kernel = KERNEL_SIMD,
+        .threads = (int)std::thread::hardware_concurrency(),
+    };
+    world.seed = 1;
+    world.resize_flock();
+
+    BoidRenderer renderer = BoidRenderer{};
+    renderer.init();
+    sg_swapchain swapchain = sg_swapchain{
+        .width = (int)world.bounds.xmax,
+        .height = (int)world.bounds.ymax,
+        .sample_count = 1,
+        .color_format = SG_PIXELFORMAT_RGBA8,
+        .depth_format = SG_PIXELFORMAT_DEPTH_STENCIL,
+    };
+
+    Snapshot snapshot = Snapshot{};
+    snapshot.capture(&world);
+
+    bool passed = true;
+    for (int frame = 0; frame < CHECK_FRAMES; frame += 1) {
+        snapshot.previous = snapshot.positions;
+        world.update(0.05);
+        snapshot.capture(&world);
+        renderer.draw(&snapshot, 0.5, swapchain);
+        sg_commit();
+
+        // after sg_commit the stats describe the frame that was just committed
+        sg_frame_stats stats = sg_query_frame_stats();
+        printf("frame %d: %d boids, %u draws, %u uniform uploads, %u buffer updates (%u bytes)\n", frame,
+               (int)world.data.boids.size(), stats.num_draw, stats.num_apply_uniforms, stats.num_update_buffer,
+               stats.size_update_buffer);
+        passed = passed && stats.num_draw == 1 && stats.num_apply_uniforms == 1 && stats.num_update_buffer == 1;
+    }
+
+    sg_shutdown();
+    printf("%s\n", passed ? "ok" : "FAILED: expected one draw call per frame");
+    return passed ? 0 : 1;
+}
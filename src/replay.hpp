@@ -0,0 +1,323 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mapped.hpp"
+#include "recorder.hpp"
+#include "simulation.hpp"
+#include "threads.hpp"
+
+// the frame on screen and the ones decoded ahead of it
+#define REPLAY_SLOTS 4
+
+static const char *check_trajectory(const TrajectoryHeader *header, uint64_t size) {
+    if (size < sizeof(TrajectoryHeader) || memcmp(header->magic, TRAJECTORY_MAGIC, sizeof(header->magic)) != 0) {
+        return "not a boids trajectory";
+    }
+    if (header->version != TRAJECTORY_VERSION) {
+        return "unsupported trajectory version";
+    }
+    if (header->byte_order != TRAJECTORY_BYTE_ORDER) {
+        return "trajectory was written with the other byte order";
+    }
+    if (header->frame_header_size != sizeof(TrajectoryFrame) || header->position_bits < 1 ||
+        header->position_bits > 24 || header->velocity_bits < 1 || header->velocity_bits > 24) {
+        return "trajectory layout does not match this build";
+    }
+    return nullptr;
+}
+
+// a recording mapped read-only. Mapping walks the frame headers once and keeps a copy of each with the offset
+// of its payload, so any frame and the keyframe a seek has to start from are found without touching the
+// payloads; a last frame cut short by a run that never finished is left out
+typedef struct TrajectoryFile {
+    MappedFile mapping;
+    const TrajectoryHeader *header;
+    std::vector<TrajectoryFrame> frames;
+    std::vector<uint64_t> payloads;
+    std::vector<int> keyframes;
+    const char *error;
+
+    static TrajectoryFile map(const char *path) {
+        TrajectoryFile file = TrajectoryFile{};
+        file.mapping = MappedFile::map(path);
+        if (file.mapping.memory == nullptr) {
+            file.error = file.mapping.error ? file.mapping.error : "not a boids trajectory";
+            return file;
+        }
+        file.header = (const TrajectoryHeader *)file.mapping.memory;
+        file.error = check_trajectory(file.header, file.mapping.size);
+        if (file.error != nullptr) {
+            return file;
+        }
+
+        const uint8_t *bytes = (const uint8_t *)file.mapping.memory;
+        uint64_t size = file.mapping.size;
+        uint64_t offset = sizeof(TrajectoryHeader);
+        while (size - offset >= sizeof(TrajectoryFrame)) {
+            // frames follow payloads of any length, so their headers are copied out rather than read in place
+            TrajectoryFrame frame;
+            memcpy(&frame, bytes + offset, sizeof(frame));
+            offset += sizeof(frame);
+            if (frame.count < 0 || frame.payload_bytes > size - offset) {
+                break;
+            }
+            if (frame.flags & TRAJECTORY_KEYFRAME) {
+                file.keyframes.push_back(file.frames.size());
+            }
+            file.frames.push_back(frame);
+            file.payloads.push_back(offset);
+            offset += frame.payload_bytes;
+        }
+        if (file.keyframes.empty() || file.keyframes[0] != 0) {
+            file.error = "trajectory does not start with a keyframe";
+        }
+        return file;
+    }
+
+    bool valid() const {
+        return this->error == nullptr;
+    }
+
+    int frame_count() const {
+        return this->valid() ? (int)this->frames.size() : 0;
+    }
+
+    const uint8_t *payload(int index) const {
+        return (const uint8_t *)this->mapping.memory + this->payloads[index];
+    }
+
+    // the last keyframe at or before `index`, where decoding towards it has to start
+    int keyframe_before(int index) const {
+        return *(std::upper_bound(this->keyframes.begin(), this->keyframes.end(), index) - 1);
+    }
+
+    void unmap() {
+        this->mapping.unmap();
+        *this = TrajectoryFile{.error = "trajectory is not mapped"};
+    }
+} TrajectoryFile;
+
+typedef struct ReplaySlot {
+    Snapshot snapshot;
+    int index;
+    int generation;
+} ReplaySlot;
+
+// plays a recording back without simulating: a thread decodes the frames after the one on screen into a small
+// ring of snapshots, `previous` being the frame before, so the renderer only ever picks up finished ones. A seek
+// drops what was decoded ahead and restarts from the keyframe before the target, the old frame stays on
+// screen until the new one is ready
+typedef struct ReplayThread {
+    TrajectoryFile file;
+    int threads;
+    float boid_scale;
+    int vertices;
+
+    // [tail, head) are decoded, `tail` is the one on screen
+    ReplaySlot slots[REPLAY_SLOTS];
+    long long head;
+    long long tail;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable published;
+    int next;
+    int seek_to;
+    int generation;
+    bool stopping;
+    bool failed;
+    std::thread thread;
+
+    // decoder thread: `decoded` is the frame the decoder's streams hold, `last` its positions
+    TrajectoryDecoder decoder;
+    ThreadPool pool;
+    std::vector<Vec2> last;
+    int decoded;
+    long long frames_decoded;
+    double decode_ns;
+
+    ~ReplayThread() {
+        this->stop();
+    }
+
+    bool open(const char *path) {
+        this->file = TrajectoryFile::map(path);
+        return this->file.valid();
+    }
+
+    void start() {
+        this->seek_to = -1;
+        this->decoded = -1;
+        this->stopping = false;
+        this->thread = std::thread(&ReplayThread::run, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->stopping = true;
+        }
+        this->wake.notify_one();
+        if (this->thread.joinable()) {
+            this->thread.join();
+        }
+    }
+
+    // frames per second of wall time that play the recording at the speed it was simulated
+    float frame_rate(float steps_per_second) const {
+        return steps_per_second / std::max(this->file.header->decimation, 1u);
+    }
+
+    void seek(int index) {
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->seek_to = std::clamp(index, 0, std::max(this->file.frame_count() - 1, 0));
+            this->generation += 1;
+        }
+        this->wake.notify_one();
+    }
+
+    // the decoded frame closest to `index` without passing it, or whatever is on screen while the decoder
+    // catches up; null until the first frame is in
+    const ReplaySlot *frame(int index) {
+        const ReplaySlot *slot;
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            slot = this->advance(index);
+        }
+        this->wake.notify_one();
+        return slot;
+    }
+
+    // blocks until frame `index` is on screen; it has to lie ahead of the frame on screen or be seeked to
+    const ReplaySlot *wait(int index) {
+        std::unique_lock<std::mutex> guard(this->lock);
+        while (true) {
+            const ReplaySlot *slot = this->advance(index);
+            this->wake.notify_one();
+            if (slot && slot->index == index && slot->generation == this->generation) {
+                return slot;
+            }
+            if (this->failed) {
+                return nullptr;
+            }
+            this->published.wait(guard);
+        }
+    }
+
+    // with the lock held; frames left behind by a seek give way to any newer frame
+    const ReplaySlot *advance(int index) {
+        while (this->tail + 1 < this->head) {
+            const ReplaySlot &current = this->slots[this->tail % REPLAY_SLOTS];
+            const ReplaySlot &upcoming = this->slots[(this->tail + 1) % REPLAY_SLOTS];
+            if (current.generation == this->generation && upcoming.index > index) {
+                break;
+            }
+            this->tail += 1;
+        }
+        return this->tail < this->head ? &this->slots[this->tail % REPLAY_SLOTS] : nullptr;
+    }
+
+    void run() {
+        this->pool.resize(this->threads);
+        while (true) {
+            int index;
+            int generation;
+            ReplaySlot *slot;
+            {
+                std::unique_lock<std::mutex> guard(this->lock);
+                this->wake.wait(guard, [this]() {
+                    return this->stopping || this->seek_to >= 0 ||
+                           (this->next < this->file.frame_count() && this->head - this->tail < REPLAY_SLOTS);
+                });
+                if (this->stopping) {
+                    return;
+                }
+                if (this->seek_to >= 0) {
+                    this->next = this->seek_to;
+                    this->seek_to = -1;
+                    this->head = std::min(this->head, this->tail + 1);
+                    continue;
+                }
+                index = this->next;
+                generation = this->generation;
+                slot = &this->slots[this->head % REPLAY_SLOTS];
+            }
+
+            auto started = std::chrono::steady_clock::now();
+            bool done = this->decode(index, &slot->snapshot);
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            this->decode_ns += std::chrono::duration<double, std::nano>(elapsed).count();
+            {
+                std::lock_guard<std::mutex> guard(this->lock);
+                if (!done) {
+                    this->failed = true;
+                    this->next = this->file.frame_count();
+                } else if (generation == this->generation) {
+                    slot->index = index;
+                    slot->generation = generation;
+                    this->head += 1;
+                    this->next = index + 1;
+                }
+            }
+            this->published.notify_all();
+        }
+    }
+
+    // a frame that does not follow the one decoded last is reached by decoding forward from its keyframe
+    bool decode(int index, Snapshot *snapshot) {
+        const TrajectoryHeader *header = this->file.header;
+        if (this->decoded != index - 1) {
+            this->decoded = -1;
+            this->last.clear();
+            // from the keyframe before the frame before, so `previous` comes out as it does playing straight through
+            for (int k = index > 0 ? this->file.keyframe_before(index - 1) : 0; k < index; k += 1) {
+                const TrajectoryFrame *frame = &this->file.frames[k];
+                bool unpack = k == index - 1;
+                if (unpack) {
+                    this->last.resize(frame->count);
+                    snapshot->velocities.resize(frame->count);
+                }
+                if (!this->decoder.decode(header, frame, this->file.payload(k), unpack ? this->last.data() : nullptr,
+                                          snapshot->velocities.data(), &this->pool)) {
+                    return false;
+                }
+                this->frames_decoded += 1;
+            }
+        }
+
+        const TrajectoryFrame *frame = &this->file.frames[index];
+        snapshot->positions.resize(frame->count);
+        snapshot->velocities.resize(frame->count);
+        if (!this->decoder.decode(header, frame, this->file.payload(index), snapshot->positions.data(),
+                                  snapshot->velocities.data(), &this->pool)) {
+            this->decoded = -1;
+            return false;
+        }
+        this->decoded = index;
+        this->frames_decoded += 1;
+
+        // ids carry over between frames of the same size, so the last positions are where these boids were
+        snapshot->previous.swap(this->last);
+        if (snapshot->previous.size() != snapshot->positions.size()) {
+            snapshot->previous.clear();
+        }
+        this->last.assign(snapshot->positions.begin(), snapshot->positions.end());
+        snapshot->bounds = frame->bounds;
+        snapshot->boid_scale = this->boid_scale;
+        snapshot->vertices = this->vertices;
+        snapshot->wrap = frame->flags & TRAJECTORY_WRAPPED;
+        snapshot->step = frame->step;
+        snapshot->stepped_at = std::chrono::steady_clock::now();
+        return true;
+    }
+} ReplayThread;
+
+#endif
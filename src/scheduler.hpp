@@ -0,0 +1,256 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "arena.hpp"
+#include "threads.hpp"
+
+#define TILE_CELLS 4
+#define TILES_PER_WORKER 8
+
+// a rectangle of grid cells, or a slice of the sorted boids of a single cell when that cell alone is too heavy
+typedef struct WorkItem {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+    int slot_begin;
+    int slot_end;
+    long long weight;
+} WorkItem;
+
+typedef struct WorkerCounters {
+    long long busy_ns;
+    long long wall_ns;
+    long long pairs;
+    int items;
+    int steals;
+
+    float utilization() const {
+        return this->wall_ns > 0 ? (float)this->busy_ns / this->wall_ns : 0;
+    }
+} WorkerCounters;
+
+// items and their order are rebuilt every pass in a varying number, so they come from the frame arena
+typedef struct TileScheduler {
+    WorkItem *items;
+    int item_count;
+    std::vector<long long> weights;
+    int *sorted;
+    int *owner;
+    int *order;
+    std::vector<int> queue_start;
+    std::vector<int> queue_end;
+    std::vector<int> queue_next;
+    std::vector<long long> queue_load;
+    std::vector<WorkerCounters> counters;
+
+    // weights every cell by its candidate pairs, count times the boids in its 3x3 stencil
+    // heavy cells are sliced unless `split` is false, for passes whose writes follow the cell rather than the boid
+    void plan(const int *cell_start, const int *cell_count, int width, int height, int workers, bool split,
+              FrameArena *arena) {
+        this->weights.resize(width * height);
+
+        long long total = 0;
+        for (int y = 0; y < height; y += 1) {
+            for (int x = 0; x < width; x += 1) {
+                this->weights[y * width + x] = this->cell_weight(cell_count, width, height, x, y);
+                total += this->weights[y * width + x];
+            }
+        }
+        long long target = std::max(total / (workers * TILES_PER_WORKER), 1LL);
+
+        // every item covers a cell of its own or is a slice of a heavy one, which bounds their number up front
+        int capacity = 0;
+        for (int cell = 0; cell < width * height; cell += 1) {
+            capacity += 1 + (this->weights[cell] > target ? this->pieces(cell_count[cell], this->weights[cell], target) : 0);
+        }
+        this->items = arena->take<WorkItem>(capacity);
+        this->item_count = 0;
+
+        for (int ty = 0; ty < height; ty += TILE_CELLS) {
+            for (int tx = 0; tx < width; tx += TILE_CELLS) {
+                int x1 = std::min(tx + TILE_CELLS, width) - 1;
+                int y1 = std::min(ty + TILE_CELLS, height) - 1;
+                bool heavy = false;
+                for (int y = ty; y <= y1 && split; y += 1) {
+                    for (int x = tx; x <= x1; x += 1) {
+                        heavy = heavy || this->weights[y * width + x] > target;
+                    }
+                }
+                if (!heavy) {
+                    this->add_cells(width, tx, ty, x1, y1);
+                    continue;
+                }
+
+                // heavy cells are cut into slices of their own boids, the light ones around them go out row by row
+                for (int y = ty; y <= y1; y += 1) {
+                    int run = tx;
+                    for (int x = tx; x <= x1; x += 1) {
+                        if (this->weights[y * width + x] <= target) {
+                            continue;
+                        }
+                        this->add_cells(width, run, y, x - 1, y);
+                        this->split_cell(cell_start, cell_count, width, x, y, target);
+                        run = x + 1;
+                    }
+                    this->add_cells(width, run, y, x1, y);
+                }
+            }
+        }
+
+        this->balance(workers, arena);
+    }
+
+    void add_cells(int width, int x0, int y0, int x1, int y1) {
+        WorkItem item = WorkItem{.x0 = x0, .y0 = y0, .x1 = x1, .y1 = y1, .slot_begin = -1, .slot_end = -1};
+        for (int y = y0; y <= y1; y += 1) {
+            for (int x = x0; x <= x1; x += 1) {
+                item.weight += this->weights[y * width + x];
+            }
+        }
+        if (item.weight > 0) {
+            this->items[this->item_count] = item;
+            this->item_count += 1;
+        }
+    }
+
+    long long cell_weight(const int *cell_count, int width, int height, int x, int y) const {
+        long long stencil = 0;
+        for (int sy = std::max(y - 1, 0); sy <= std::min(y + 1, height - 1); sy += 1) {
+            for (int sx = std::max(x - 1, 0); sx <= std::min(x + 1, width - 1); sx += 1) {
+                stencil += cell_count[sy * width + sx];
+            }
+        }
+        return cell_count[y * width + x] * stencil;
+    }
+
+    void split_cell(const int *cell_start, const int *cell_count, int width, int x, int y, long long target) {
+        int cell = y * width + x;
+        int count = cell_count[cell];
+        long long weight = this->weights[cell];
+        int pieces = this->pieces(count, weight, target);
+        for (int piece = 0; piece < pieces; piece += 1) {
+            int begin = cell_start[cell] + (long long)count * piece / pieces;
+            int end = cell_start[cell] + (long long)count * (piece + 1) / pieces;
+            this->items[this->item_count] = WorkItem{
+                .x0 = x,
+                .y0 = y,
+                .x1 = x,
+                .y1 = y,
+                .slot_begin = begin,
+                .slot_end = end,
+                .weight = weight * (end - begin) / count,
+            };
+            this->item_count += 1;
+        }
+    }
+
+    int pieces(int count, long long weight, long long target) const {
+        return std::min<long long>((weight + target - 1) / target, count);
+    }
+
+    // longest item first onto the least loaded queue, so stealing only has to fix up the estimate error
+    void balance(int workers, FrameArena *arena) {
+        int count = this->item_count;
+        this->sorted = arena->take<int>(count);
+        for (int i = 0; i < count; i += 1) {
+            this->sorted[i] = i;
+        }
+        std::sort(this->sorted, this->sorted + count,
+                  [&](int a, int b) { return this->items[a].weight > this->items[b].weight; });
+
+        this->owner = arena->take<int>(count);
+        this->queue_load.assign(workers, 0);
+        this->queue_start.assign(workers + 1, 0);
+        for (int i = 0; i < count; i += 1) {
+            int item = this->sorted[i];
+            int lightest = std::min_element(this->queue_load.begin(), this->queue_load.end()) - this->queue_load.begin();
+            this->owner[i] = lightest;
+            this->queue_load[lightest] += this->items[item].weight;
+            this->queue_start[lightest + 1] += 1;
+        }
+        for (int worker = 0; worker < workers; worker += 1) {
+            this->queue_start[worker + 1] += this->queue_start[worker];
+        }
+
+        this->order = arena->take<int>(count);
+        this->queue_next.assign(this->queue_start.begin(), this->queue_start.end() - 1);
+        for (int i = 0; i < count; i += 1) {
+            this->order[this->queue_next[this->owner[i]]] = this->sorted[i];
+            this->queue_next[this->owner[i]] += 1;
+        }
+        this->queue_end.assign(this->queue_start.begin() + 1, this->queue_start.end());
+        this->queue_next.assign(this->queue_start.begin(), this->queue_start.end() - 1);
+        this->counters.assign(workers, WorkerCounters{});
+    }
+
+    // `process(item, worker)` returns the pairs it evaluated; idle workers steal from the fullest queue
+    template <typename Process> void run(ThreadPool *pool, Process process) {
+        auto started = std::chrono::steady_clock::now();
+        auto work = [&](int worker) {
+            WorkerCounters &counters = this->counters[worker];
+            int victim = worker;
+            while (true) {
+                int slot = std::atomic_ref<int>(this->queue_next[victim]).fetch_add(1);
+                if (slot >= this->queue_end[victim]) {
+                    victim = this->fullest_queue();
+                    if (victim < 0) {
+                        break;
+                    }
+                    continue;
+                }
+
+                auto begin = std::chrono::steady_clock::now();
+                counters.pairs += process(&this->items[this->order[slot]], worker);
+                counters.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - begin)
+                                        .count();
+                counters.items += 1;
+                counters.steals += victim != worker;
+            }
+        };
+        pool->run(work);
+        this->finish(started);
+    }
+
+    // utilization is busy time over the whole pass, so a worker that ran dry early shows up as idle
+    void finish(std::chrono::steady_clock::time_point started) {
+        long long wall_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count();
+        for (WorkerCounters &counters : this->counters) {
+            counters.wall_ns = wall_ns;
+        }
+    }
+
+    int fullest_queue() {
+        int fullest = -1;
+        int most = 0;
+        for (int worker = 0; worker < (int)this->queue_end.size(); worker += 1) {
+            int next = std::atomic_ref<int>(this->queue_next[worker]).load(std::memory_order_relaxed);
+            int remaining = this->queue_end[worker] - next;
+            if (remaining > most) {
+                most = remaining;
+                fullest = worker;
+            }
+        }
+        return fullest;
+    }
+
+    // slowest worker's pairs over the mean; 1 is a perfect split
+    float imbalance() const {
+        long long most = 0;
+        long long total = 0;
+        for (const WorkerCounters &counters : this->counters) {
+            most = std::max(most, counters.pairs);
+            total += counters.pairs;
+        }
+        return total > 0 ? (float)most * this->counters.size() / total : 1;
+    }
+} TileScheduler;
+
+#endif
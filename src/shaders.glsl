@@ -5,32 +5,29 @@
         
 in vec2 v_pos;
 in vec3 v_color;
+in vec2 i_pos;
+in vec2 i_vel;
+in float i_scale;
 
 out vec3 f_color;
 out float f_angle;
 
-layout (binding = 0) uniform v_params_boid {
-    vec2 pos;
-    vec2 vel;
-    float scale;
-};
-
-layout (binding = 1) uniform v_params_world {
+layout (binding = 0) uniform v_params_world {
     vec2 world_dims;
 };
 
 void main() {
     f_color = v_color;
-    f_angle = atan(vel.y, vel.x);
+    f_angle = atan(i_vel.y, i_vel.x);
     
-    vec2 local = v_pos * scale;
+    vec2 local = v_pos * i_scale;
     
     float angle = f_angle - PI / 2;
     float rotx = local.x * cos(angle) - local.y * sin(angle);
     float roty = local.x * sin(angle) + local.y * cos(angle);
     vec2 rotated = vec2(rotx, roty);
 
-    vec2 world = pos + rotated;
+    vec2 world = i_pos + rotated;
 
     float ndcx = (world.x / world_dims.x) * 2. - 1.;
     float ndcy = (world.y / world_dims.y) * 2. - 1.;
@@ -16,13 +16,13 @@
         Attributes:
             ATTR_simple_v_pos => 0
             ATTR_simple_v_color => 1
+            ATTR_simple_i_pos => 2
+            ATTR_simple_i_vel => 3
+            ATTR_simple_i_scale => 4
     Bindings:
-        Uniform block 'v_params_boid':
-            C struct: v_params_boid_t
-            Bind slot: UB_v_params_boid => 0
         Uniform block 'v_params_world':
             C struct: v_params_world_t
-            Bind slot: UB_v_params_world => 1
+            Bind slot: UB_v_params_world => 0
 */
 #if !defined(SOKOL_GFX_INCLUDED)
 #error "Please include sokol_gfx.h before shaders.hpp"
@@ -36,16 +36,10 @@
 #endif
 #define ATTR_simple_v_pos (0)
 #define ATTR_simple_v_color (1)
-#define UB_v_params_boid (0)
-#define UB_v_params_world (1)
-#pragma pack(push,1)
-SOKOL_SHDC_ALIGN(16) typedef struct v_params_boid_t {
-    float pos[2];
-    float vel[2];
-    float scale;
-    uint8_t _pad_20[12];
-} v_params_boid_t;
-#pragma pack(pop)
+#define ATTR_simple_i_pos (2)
+#define ATTR_simple_i_vel (3)
+#define ATTR_simple_i_scale (4)
+#define UB_v_params_world (0)
 #pragma pack(push,1)
 SOKOL_SHDC_ALIGN(16) typedef struct v_params_world_t {
     float world_dims[2];
@@ -55,76 +49,80 @@ SOKOL_SHDC_ALIGN(16) typedef struct v_params_world_t {
 /*
     #version 430
 
-    uniform vec4 v_params_boid[2];
     uniform vec4 v_params_world[1];
     layout(location = 0) out vec3 f_color;
     layout(location = 1) in vec3 v_color;
     layout(location = 1) out float f_angle;
+    layout(location = 3) in vec2 i_vel;
     layout(location = 0) in vec2 v_pos;
+    layout(location = 4) in float i_scale;
+    layout(location = 2) in vec2 i_pos;
 
     void main()
     {
         f_color = v_color;
-        f_angle = atan(v_params_boid[0].w, v_params_boid[0].z);
-        vec2 _38 = v_pos * v_params_boid[1].x;
+        f_angle = atan(i_vel.y, i_vel.x);
+        vec2 _38 = v_pos * i_scale;
         float _43 = f_angle - 1.57079601287841796875;
         float _46 = _38.x;
         float _48 = cos(_43);
         float _51 = _38.y;
         float _53 = sin(_43);
-        vec2 _78 = v_params_boid[0].xy + vec2(fma(_46, _48, -(_51 * _53)), fma(_46, _53, _51 * _48));
+        vec2 _78 = i_pos + vec2(fma(_46, _48, -(_51 * _53)), fma(_46, _53, _51 * _48));
         gl_Position = vec4(fma(_78.x / v_params_world[0].x, 2.0, -1.0), fma(_78.y / v_params_world[0].y, 2.0, -1.0), 0.0, 1.0);
     }
 
 */
-static const uint8_t simple_vs_source_glsl430[745] = {
+static const uint8_t simple_vs_source_glsl430[778] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x34,0x33,0x30,0x0a,0x0a,0x75,0x6e,
     0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x5f,0x70,0x61,0x72,
-    0x61,0x6d,0x73,0x5f,0x62,0x6f,0x69,0x64,0x5b,0x32,0x5d,0x3b,0x0a,0x75,0x6e,0x69,
-    0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,
-    0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5b,0x31,0x5d,0x3b,0x0a,0x6c,0x61,0x79,
-    0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,
-    0x29,0x20,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x66,0x5f,0x63,0x6f,0x6c,
-    0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,
-    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,
-    0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
-    0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x6f,
-    0x75,0x74,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,
+    0x61,0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5b,0x31,0x5d,0x3b,0x0a,0x6c,0x61,
+    0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
+    0x30,0x29,0x20,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x66,0x5f,0x63,0x6f,
+    0x6c,0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,
+    0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,
+    0x33,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
+    0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,
+    0x6f,0x75,0x74,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,
+    0x65,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,
+    0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,
+    0x69,0x5f,0x76,0x65,0x6c,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
+    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x32,0x20,0x76,0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
+    0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,0x29,0x20,
+    0x69,0x6e,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x69,0x5f,0x73,0x63,0x61,0x6c,0x65,
     0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,
-    0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x76,
+    0x6e,0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x69,
     0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,
     0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
     0x20,0x3d,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x3d,0x20,0x61,0x74,0x61,0x6e,0x28,0x76,
-    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x62,0x6f,0x69,0x64,0x5b,0x30,0x5d,0x2e,
-    0x77,0x2c,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x62,0x6f,0x69,0x64,
-    0x5b,0x30,0x5d,0x2e,0x7a,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,
-    0x20,0x5f,0x33,0x38,0x20,0x3d,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x2a,0x20,0x76,
-    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x62,0x6f,0x69,0x64,0x5b,0x31,0x5d,0x2e,
-    0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x33,
-    0x20,0x3d,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x2d,0x20,0x31,0x2e,0x35,
-    0x37,0x30,0x37,0x39,0x36,0x30,0x31,0x32,0x38,0x37,0x38,0x34,0x31,0x37,0x39,0x36,
-    0x38,0x37,0x35,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,
-    0x34,0x36,0x20,0x3d,0x20,0x5f,0x33,0x38,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x38,0x20,0x3d,0x20,0x63,0x6f,0x73,0x28,
-    0x5f,0x34,0x33,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,
-    0x5f,0x35,0x31,0x20,0x3d,0x20,0x5f,0x33,0x38,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x20,
-    0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x35,0x33,0x20,0x3d,0x20,0x73,0x69,0x6e,
-    0x28,0x5f,0x34,0x33,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,
-    0x5f,0x37,0x38,0x20,0x3d,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x62,
-    0x6f,0x69,0x64,0x5b,0x30,0x5d,0x2e,0x78,0x79,0x20,0x2b,0x20,0x76,0x65,0x63,0x32,
-    0x28,0x66,0x6d,0x61,0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x34,0x38,0x2c,0x20,0x2d,
-    0x28,0x5f,0x35,0x31,0x20,0x2a,0x20,0x5f,0x35,0x33,0x29,0x29,0x2c,0x20,0x66,0x6d,
-    0x61,0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x35,0x33,0x2c,0x20,0x5f,0x35,0x31,0x20,
-    0x2a,0x20,0x5f,0x34,0x38,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,
-    0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x76,0x65,0x63,0x34,0x28,
-    0x66,0x6d,0x61,0x28,0x5f,0x37,0x38,0x2e,0x78,0x20,0x2f,0x20,0x76,0x5f,0x70,0x61,
-    0x72,0x61,0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5b,0x30,0x5d,0x2e,0x78,0x2c,
-    0x20,0x32,0x2e,0x30,0x2c,0x20,0x2d,0x31,0x2e,0x30,0x29,0x2c,0x20,0x66,0x6d,0x61,
-    0x28,0x5f,0x37,0x38,0x2e,0x79,0x20,0x2f,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,
-    0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5b,0x30,0x5d,0x2e,0x79,0x2c,0x20,0x32,0x2e,
-    0x30,0x2c,0x20,0x2d,0x31,0x2e,0x30,0x29,0x2c,0x20,0x30,0x2e,0x30,0x2c,0x20,0x31,
-    0x2e,0x30,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
+    0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x3d,0x20,0x61,0x74,0x61,0x6e,0x28,0x69,
+    0x5f,0x76,0x65,0x6c,0x2e,0x79,0x2c,0x20,0x69,0x5f,0x76,0x65,0x6c,0x2e,0x78,0x29,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x5f,0x33,0x38,0x20,0x3d,
+    0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x2a,0x20,0x69,0x5f,0x73,0x63,0x61,0x6c,0x65,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x33,0x20,
+    0x3d,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x2d,0x20,0x31,0x2e,0x35,0x37,
+    0x30,0x37,0x39,0x36,0x30,0x31,0x32,0x38,0x37,0x38,0x34,0x31,0x37,0x39,0x36,0x38,
+    0x37,0x35,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,
+    0x36,0x20,0x3d,0x20,0x5f,0x33,0x38,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x38,0x20,0x3d,0x20,0x63,0x6f,0x73,0x28,0x5f,
+    0x34,0x33,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,
+    0x35,0x31,0x20,0x3d,0x20,0x5f,0x33,0x38,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x35,0x33,0x20,0x3d,0x20,0x73,0x69,0x6e,0x28,
+    0x5f,0x34,0x33,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x5f,
+    0x37,0x38,0x20,0x3d,0x20,0x69,0x5f,0x70,0x6f,0x73,0x20,0x2b,0x20,0x76,0x65,0x63,
+    0x32,0x28,0x66,0x6d,0x61,0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x34,0x38,0x2c,0x20,
+    0x2d,0x28,0x5f,0x35,0x31,0x20,0x2a,0x20,0x5f,0x35,0x33,0x29,0x29,0x2c,0x20,0x66,
+    0x6d,0x61,0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x35,0x33,0x2c,0x20,0x5f,0x35,0x31,
+    0x20,0x2a,0x20,0x5f,0x34,0x38,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,
+    0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x76,0x65,0x63,0x34,
+    0x28,0x66,0x6d,0x61,0x28,0x5f,0x37,0x38,0x2e,0x78,0x20,0x2f,0x20,0x76,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5b,0x30,0x5d,0x2e,0x78,
+    0x2c,0x20,0x32,0x2e,0x30,0x2c,0x20,0x2d,0x31,0x2e,0x30,0x29,0x2c,0x20,0x66,0x6d,
+    0x61,0x28,0x5f,0x37,0x38,0x2e,0x79,0x20,0x2f,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5b,0x30,0x5d,0x2e,0x79,0x2c,0x20,0x32,
+    0x2e,0x30,0x2c,0x20,0x2d,0x31,0x2e,0x30,0x29,0x2c,0x20,0x30,0x2e,0x30,0x2c,0x20,
+    0x31,0x2e,0x30,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     #version 430
@@ -162,14 +160,7 @@ static const uint8_t simple_fs_source_glsl430[315] = {
     0x31,0x32,0x35,0x29,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
-    cbuffer v_params_boid : register(b0)
-    {
-        float2 _18_pos : packoffset(c0);
-        float2 _18_vel : packoffset(c0.z);
-        float _18_scale : packoffset(c1);
-    };
-
-    cbuffer v_params_world : register(b1)
+    cbuffer v_params_world : register(b0)
     {
         float2 _84_world_dims : packoffset(c0);
     };
@@ -179,12 +170,18 @@ static const uint8_t simple_fs_source_glsl430[315] = {
     static float3 f_color;
     static float3 v_color;
     static float f_angle;
+    static float2 i_vel;
     static float2 v_pos;
+    static float i_scale;
+    static float2 i_pos;
 
     struct SPIRV_Cross_Input
     {
         float2 v_pos : TEXCOORD0;
         float3 v_color : TEXCOORD1;
+        float2 i_pos : TEXCOORD2;
+        float2 i_vel : TEXCOORD3;
+        float i_scale : TEXCOORD4;
     };
 
     struct SPIRV_Cross_Output
@@ -197,21 +194,24 @@ static const uint8_t simple_fs_source_glsl430[315] = {
     void vert_main()
     {
         f_color = v_color;
-        f_angle = atan2(_18_vel.y, _18_vel.x);
-        float2 _38 = v_pos * _18_scale;
+        f_angle = atan2(i_vel.y, i_vel.x);
+        float2 _38 = v_pos * i_scale;
         float _43 = f_angle - 1.57079601287841796875f;
         float _46 = _38.x;
         float _48 = cos(_43);
         float _51 = _38.y;
         float _53 = sin(_43);
-        float2 _78 = _18_pos + float2(mad(_46, _48, -(_51 * _53)), mad(_46, _53, _51 * _48));
+        float2 _78 = i_pos + float2(mad(_46, _48, -(_51 * _53)), mad(_46, _53, _51 * _48));
         gl_Position = float4(mad(_78.x / _84_world_dims.x, 2.0f, -1.0f), mad(_78.y / _84_world_dims.y, 2.0f, -1.0f), 0.0f, 1.0f);
     }
 
     SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
     {
         v_color = stage_input.v_color;
+        i_vel = stage_input.i_vel;
         v_pos = stage_input.v_pos;
+        i_scale = stage_input.i_scale;
+        i_pos = stage_input.i_pos;
         vert_main();
         SPIRV_Cross_Output stage_output;
         stage_output.gl_Position = gl_Position;
@@ -220,95 +220,100 @@ static const uint8_t simple_fs_source_glsl430[315] = {
         return stage_output;
     }
 */
-static const uint8_t simple_vs_source_hlsl5[1399] = {
+static const uint8_t simple_vs_source_hlsl5[1486] = {
     0x63,0x62,0x75,0x66,0x66,0x65,0x72,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
-    0x5f,0x62,0x6f,0x69,0x64,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,0x74,0x65,0x72,
-    0x28,0x62,0x30,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,
-    0x32,0x20,0x5f,0x31,0x38,0x5f,0x70,0x6f,0x73,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,
-    0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x5f,0x31,0x38,0x5f,0x76,0x65,0x6c,0x20,0x3a,
-    0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x30,0x2e,0x7a,
-    0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x31,0x38,
-    0x5f,0x73,0x63,0x61,0x6c,0x65,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,
-    0x73,0x65,0x74,0x28,0x63,0x31,0x29,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x63,0x62,0x75,
-    0x66,0x66,0x65,0x72,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x77,0x6f,
-    0x72,0x6c,0x64,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,0x74,0x65,0x72,0x28,0x62,
-    0x31,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,
-    0x5f,0x38,0x34,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,0x73,0x20,0x3a,
-    0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,0x30,0x29,0x3b,
-    0x0a,0x7d,0x3b,0x0a,0x0a,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,
-    0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,
-    0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x66,
-    0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,
-    0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x73,
-    0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x5f,0x61,0x6e,
-    0x67,0x6c,0x65,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,
-    0x74,0x32,0x20,0x76,0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,
-    0x74,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x49,0x6e,
-    0x70,0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,
-    0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,
-    0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,
-    0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,
-    0x44,0x31,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x53,
-    0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,
-    0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x66,
-    0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,
-    0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x5f,
-    0x61,0x6e,0x67,0x6c,0x65,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,
-    0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,
-    0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3a,0x20,0x53,0x56,0x5f,0x50,
-    0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x76,0x6f,0x69,
-    0x64,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,
-    0x20,0x20,0x20,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x76,0x5f,
-    0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x5f,0x61,0x6e,0x67,
-    0x6c,0x65,0x20,0x3d,0x20,0x61,0x74,0x61,0x6e,0x32,0x28,0x5f,0x31,0x38,0x5f,0x76,
-    0x65,0x6c,0x2e,0x79,0x2c,0x20,0x5f,0x31,0x38,0x5f,0x76,0x65,0x6c,0x2e,0x78,0x29,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x5f,0x33,0x38,
-    0x20,0x3d,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x2a,0x20,0x5f,0x31,0x38,0x5f,0x73,
-    0x63,0x61,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,
-    0x5f,0x34,0x33,0x20,0x3d,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x2d,0x20,
-    0x31,0x2e,0x35,0x37,0x30,0x37,0x39,0x36,0x30,0x31,0x32,0x38,0x37,0x38,0x34,0x31,
-    0x37,0x39,0x36,0x38,0x37,0x35,0x66,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,
-    0x61,0x74,0x20,0x5f,0x34,0x36,0x20,0x3d,0x20,0x5f,0x33,0x38,0x2e,0x78,0x3b,0x0a,
-    0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x38,0x20,0x3d,0x20,
-    0x63,0x6f,0x73,0x28,0x5f,0x34,0x33,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,
-    0x6f,0x61,0x74,0x20,0x5f,0x35,0x31,0x20,0x3d,0x20,0x5f,0x33,0x38,0x2e,0x79,0x3b,
-    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x35,0x33,0x20,0x3d,
-    0x20,0x73,0x69,0x6e,0x28,0x5f,0x34,0x33,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
-    0x6c,0x6f,0x61,0x74,0x32,0x20,0x5f,0x37,0x38,0x20,0x3d,0x20,0x5f,0x31,0x38,0x5f,
-    0x70,0x6f,0x73,0x20,0x2b,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x28,0x6d,0x61,0x64,
-    0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x34,0x38,0x2c,0x20,0x2d,0x28,0x5f,0x35,0x31,
-    0x20,0x2a,0x20,0x5f,0x35,0x33,0x29,0x29,0x2c,0x20,0x6d,0x61,0x64,0x28,0x5f,0x34,
-    0x36,0x2c,0x20,0x5f,0x35,0x33,0x2c,0x20,0x5f,0x35,0x31,0x20,0x2a,0x20,0x5f,0x34,
-    0x38,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,
-    0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x28,0x6d,0x61,
-    0x64,0x28,0x5f,0x37,0x38,0x2e,0x78,0x20,0x2f,0x20,0x5f,0x38,0x34,0x5f,0x77,0x6f,
-    0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,0x73,0x2e,0x78,0x2c,0x20,0x32,0x2e,0x30,0x66,
-    0x2c,0x20,0x2d,0x31,0x2e,0x30,0x66,0x29,0x2c,0x20,0x6d,0x61,0x64,0x28,0x5f,0x37,
-    0x38,0x2e,0x79,0x20,0x2f,0x20,0x5f,0x38,0x34,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5f,
-    0x64,0x69,0x6d,0x73,0x2e,0x79,0x2c,0x20,0x32,0x2e,0x30,0x66,0x2c,0x20,0x2d,0x31,
-    0x2e,0x30,0x66,0x29,0x2c,0x20,0x30,0x2e,0x30,0x66,0x2c,0x20,0x31,0x2e,0x30,0x66,
-    0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,
-    0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x6d,0x61,0x69,0x6e,0x28,0x53,0x50,
-    0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x49,0x6e,0x70,0x75,0x74,0x20,
-    0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x29,0x0a,0x7b,0x0a,0x20,
-    0x20,0x20,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x73,0x74,0x61,
-    0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x3d,0x20,0x73,0x74,
-    0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x76,0x5f,0x70,0x6f,0x73,0x3b,
-    0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,
-    0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,
-    0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,
-    0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,
-    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,
-    0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,
-    0x70,0x75,0x74,0x2e,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x66,0x5f,
-    0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,0x61,0x67,0x65,
-    0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,
-    0x3d,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,
-    0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,
-    0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
+    0x5f,0x77,0x6f,0x72,0x6c,0x64,0x20,0x3a,0x20,0x72,0x65,0x67,0x69,0x73,0x74,0x65,
+    0x72,0x28,0x62,0x30,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x32,0x20,0x5f,0x38,0x34,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,
+    0x73,0x20,0x3a,0x20,0x70,0x61,0x63,0x6b,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x63,
+    0x30,0x29,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,
+    0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,
+    0x6f,0x6e,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,
+    0x33,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,
+    0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
+    0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,
+    0x5f,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x32,0x20,0x69,0x5f,0x76,0x65,0x6c,0x3b,0x0a,0x73,0x74,0x61,
+    0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x76,0x5f,0x70,0x6f,0x73,
+    0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x69,
+    0x5f,0x73,0x63,0x61,0x6c,0x65,0x3b,0x0a,0x73,0x74,0x61,0x74,0x69,0x63,0x20,0x66,
+    0x6c,0x6f,0x61,0x74,0x32,0x20,0x69,0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x0a,0x73,0x74,
+    0x72,0x75,0x63,0x74,0x20,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,
+    0x5f,0x49,0x6e,0x70,0x75,0x74,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x32,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,
+    0x4f,0x4f,0x52,0x44,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,
+    0x33,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,
+    0x4f,0x4f,0x52,0x44,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,
+    0x32,0x20,0x69,0x5f,0x70,0x6f,0x73,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,
+    0x52,0x44,0x32,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,
+    0x69,0x5f,0x76,0x65,0x6c,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,
+    0x33,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x69,0x5f,0x73,
+    0x63,0x61,0x6c,0x65,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x34,
+    0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,0x53,0x50,0x49,
+    0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x0a,
+    0x7b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x33,0x20,0x66,0x5f,0x63,
+    0x6f,0x6c,0x6f,0x72,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x30,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x5f,0x61,0x6e,
+    0x67,0x6c,0x65,0x20,0x3a,0x20,0x54,0x45,0x58,0x43,0x4f,0x4f,0x52,0x44,0x31,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x34,0x20,0x67,0x6c,0x5f,0x50,
+    0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3a,0x20,0x53,0x56,0x5f,0x50,0x6f,0x73,
+    0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x7d,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,
+    0x76,0x65,0x72,0x74,0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,
+    0x20,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x76,0x5f,0x63,0x6f,
+    0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,
+    0x20,0x3d,0x20,0x61,0x74,0x61,0x6e,0x32,0x28,0x69,0x5f,0x76,0x65,0x6c,0x2e,0x79,
+    0x2c,0x20,0x69,0x5f,0x76,0x65,0x6c,0x2e,0x78,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x5f,0x33,0x38,0x20,0x3d,0x20,0x76,0x5f,0x70,
+    0x6f,0x73,0x20,0x2a,0x20,0x69,0x5f,0x73,0x63,0x61,0x6c,0x65,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x33,0x20,0x3d,0x20,0x66,0x5f,
+    0x61,0x6e,0x67,0x6c,0x65,0x20,0x2d,0x20,0x31,0x2e,0x35,0x37,0x30,0x37,0x39,0x36,
+    0x30,0x31,0x32,0x38,0x37,0x38,0x34,0x31,0x37,0x39,0x36,0x38,0x37,0x35,0x66,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x34,0x36,0x20,0x3d,
+    0x20,0x5f,0x33,0x38,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x20,0x5f,0x34,0x38,0x20,0x3d,0x20,0x63,0x6f,0x73,0x28,0x5f,0x34,0x33,0x29,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x35,0x31,0x20,
+    0x3d,0x20,0x5f,0x33,0x38,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x20,0x5f,0x35,0x33,0x20,0x3d,0x20,0x73,0x69,0x6e,0x28,0x5f,0x34,0x33,
+    0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x32,0x20,0x5f,0x37,
+    0x38,0x20,0x3d,0x20,0x69,0x5f,0x70,0x6f,0x73,0x20,0x2b,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x32,0x28,0x6d,0x61,0x64,0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x34,0x38,0x2c,
+    0x20,0x2d,0x28,0x5f,0x35,0x31,0x20,0x2a,0x20,0x5f,0x35,0x33,0x29,0x29,0x2c,0x20,
+    0x6d,0x61,0x64,0x28,0x5f,0x34,0x36,0x2c,0x20,0x5f,0x35,0x33,0x2c,0x20,0x5f,0x35,
+    0x31,0x20,0x2a,0x20,0x5f,0x34,0x38,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,
+    0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x66,0x6c,0x6f,
+    0x61,0x74,0x34,0x28,0x6d,0x61,0x64,0x28,0x5f,0x37,0x38,0x2e,0x78,0x20,0x2f,0x20,
+    0x5f,0x38,0x34,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,0x73,0x2e,0x78,
+    0x2c,0x20,0x32,0x2e,0x30,0x66,0x2c,0x20,0x2d,0x31,0x2e,0x30,0x66,0x29,0x2c,0x20,
+    0x6d,0x61,0x64,0x28,0x5f,0x37,0x38,0x2e,0x79,0x20,0x2f,0x20,0x5f,0x38,0x34,0x5f,
+    0x77,0x6f,0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,0x73,0x2e,0x79,0x2c,0x20,0x32,0x2e,
+    0x30,0x66,0x2c,0x20,0x2d,0x31,0x2e,0x30,0x66,0x29,0x2c,0x20,0x30,0x2e,0x30,0x66,
+    0x2c,0x20,0x31,0x2e,0x30,0x66,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x53,0x50,0x49,0x52,
+    0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,0x6d,
+    0x61,0x69,0x6e,0x28,0x53,0x50,0x49,0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,
+    0x49,0x6e,0x70,0x75,0x74,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,
+    0x74,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
+    0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x76,
+    0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x5f,0x76,0x65,
+    0x6c,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,
+    0x69,0x5f,0x76,0x65,0x6c,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x5f,0x70,0x6f,0x73,
+    0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,0x76,
+    0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x5f,0x73,0x63,0x61,0x6c,
+    0x65,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,0x2e,
+    0x69,0x5f,0x73,0x63,0x61,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x5f,0x70,
+    0x6f,0x73,0x20,0x3d,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x69,0x6e,0x70,0x75,0x74,
+    0x2e,0x69,0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x72,0x74,
+    0x5f,0x6d,0x61,0x69,0x6e,0x28,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x53,0x50,0x49,
+    0x52,0x56,0x5f,0x43,0x72,0x6f,0x73,0x73,0x5f,0x4f,0x75,0x74,0x70,0x75,0x74,0x20,
+    0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x67,
+    0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x67,0x6c,0x5f,
+    0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x73,0x74,
+    0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x66,0x5f,0x63,0x6f,0x6c,
+    0x6f,0x72,0x20,0x3d,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x73,0x74,0x61,0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x2e,0x66,
+    0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x3d,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x73,0x74,0x61,
+    0x67,0x65,0x5f,0x6f,0x75,0x74,0x70,0x75,0x74,0x3b,0x0a,0x7d,0x0a,0x00,
 };
 /*
     static float f_angle;
@@ -388,15 +393,6 @@ static const uint8_t simple_fs_source_hlsl5[659] = {
 /*
     diagnostic(off, derivative_uniformity);
 
-    struct v_params_boid {
-      /_ @offset(0) _/
-      pos : vec2f,
-      /_ @offset(8) _/
-      vel : vec2f,
-      /_ @offset(16) _/
-      scale : f32,
-    }
-
     struct v_params_world {
       /_ @offset(0) _/
       world_dims : vec2f,
@@ -408,11 +404,15 @@ static const uint8_t simple_fs_source_hlsl5[659] = {
 
     var<private> f_angle : f32;
 
-    @group(0) @binding(0) var<uniform> x_18 : v_params_boid;
+    var<private> i_vel : vec2f;
 
     var<private> v_pos : vec2f;
 
-    @group(0) @binding(1) var<uniform> x_84 : v_params_world;
+    var<private> i_scale : f32;
+
+    var<private> i_pos : vec2f;
+
+    @group(0) @binding(0) var<uniform> x_84 : v_params_world;
 
     var<private> gl_Position : vec4f;
 
@@ -428,11 +428,11 @@ static const uint8_t simple_fs_source_hlsl5[659] = {
       var ndc : vec2f;
       let x_12 : vec3f = v_color;
       f_color = x_12;
-      let x_25 : f32 = x_18.vel.y;
-      let x_28 : f32 = x_18.vel.x;
+      let x_25 : f32 = i_vel.y;
+      let x_28 : f32 = i_vel.x;
       f_angle = atan2(x_25, x_28);
       let x_34 : vec2f = v_pos;
-      let x_37 : f32 = x_18.scale;
+      let x_37 : f32 = i_scale;
       local = (x_34 * x_37);
       let x_41 : f32 = f_angle;
       angle = (x_41 - 1.57079601287841796875f);
@@ -449,7 +449,7 @@ static const uint8_t simple_fs_source_hlsl5[659] = {
       let x_69 : f32 = rotx;
       let x_70 : f32 = roty;
       rotated = vec2f(x_69, x_70);
-      let x_76 : vec2f = x_18.pos;
+      let x_76 : vec2f = i_pos;
       let x_77 : vec2f = rotated;
       world = (x_76 + x_77);
       let x_81 : f32 = world.x;
@@ -476,104 +476,100 @@ static const uint8_t simple_fs_source_hlsl5[659] = {
     }
 
     @vertex
-    fn main(@location(1) v_color_param : vec3f, @location(0) v_pos_param : vec2f) -> main_out {
+    fn main(@location(1) v_color_param : vec3f, @location(3) i_vel_param : vec2f, @location(0) v_pos_param : vec2f, @location(4) i_scale_param : f32, @location(2) i_pos_param : vec2f) -> main_out {
       v_color = v_color_param;
+      i_vel = i_vel_param;
       v_pos = v_pos_param;
+      i_scale = i_scale_param;
+      i_pos = i_pos_param;
       main_1();
       return main_out(f_color, f_angle, gl_Position);
     }
 
 */
-static const uint8_t simple_vs_source_wgsl[2224] = {
+static const uint8_t simple_vs_source_wgsl[2287] = {
     0x64,0x69,0x61,0x67,0x6e,0x6f,0x73,0x74,0x69,0x63,0x28,0x6f,0x66,0x66,0x2c,0x20,
     0x64,0x65,0x72,0x69,0x76,0x61,0x74,0x69,0x76,0x65,0x5f,0x75,0x6e,0x69,0x66,0x6f,
     0x72,0x6d,0x69,0x74,0x79,0x29,0x3b,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,0x20,
-    0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x62,0x6f,0x69,0x64,0x20,0x7b,0x0a,
-    0x20,0x20,0x2f,0x2a,0x20,0x40,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x30,0x29,0x20,
-    0x2a,0x2f,0x0a,0x20,0x20,0x70,0x6f,0x73,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,
-    0x2c,0x0a,0x20,0x20,0x2f,0x2a,0x20,0x40,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x38,
-    0x29,0x20,0x2a,0x2f,0x0a,0x20,0x20,0x76,0x65,0x6c,0x20,0x3a,0x20,0x76,0x65,0x63,
-    0x32,0x66,0x2c,0x0a,0x20,0x20,0x2f,0x2a,0x20,0x40,0x6f,0x66,0x66,0x73,0x65,0x74,
-    0x28,0x31,0x36,0x29,0x20,0x2a,0x2f,0x0a,0x20,0x20,0x73,0x63,0x61,0x6c,0x65,0x20,
-    0x3a,0x20,0x66,0x33,0x32,0x2c,0x0a,0x7d,0x0a,0x0a,0x73,0x74,0x72,0x75,0x63,0x74,
-    0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x20,
-    0x7b,0x0a,0x20,0x20,0x2f,0x2a,0x20,0x40,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x30,
-    0x29,0x20,0x2a,0x2f,0x0a,0x20,0x20,0x77,0x6f,0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,
-    0x73,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x2c,0x0a,0x7d,0x0a,0x0a,0x76,0x61,
-    0x72,0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x66,0x5f,0x63,0x6f,0x6c,
-    0x6f,0x72,0x20,0x3a,0x20,0x76,0x65,0x63,0x33,0x66,0x3b,0x0a,0x0a,0x76,0x61,0x72,
-    0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,
+    0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x20,0x7b,
+    0x0a,0x20,0x20,0x2f,0x2a,0x20,0x40,0x6f,0x66,0x66,0x73,0x65,0x74,0x28,0x30,0x29,
+    0x20,0x2a,0x2f,0x0a,0x20,0x20,0x77,0x6f,0x72,0x6c,0x64,0x5f,0x64,0x69,0x6d,0x73,
+    0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x2c,0x0a,0x7d,0x0a,0x0a,0x76,0x61,0x72,
+    0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,
     0x72,0x20,0x3a,0x20,0x76,0x65,0x63,0x33,0x66,0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,
-    0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,
-    0x20,0x3a,0x20,0x66,0x33,0x32,0x3b,0x0a,0x0a,0x40,0x67,0x72,0x6f,0x75,0x70,0x28,
-    0x30,0x29,0x20,0x40,0x62,0x69,0x6e,0x64,0x69,0x6e,0x67,0x28,0x30,0x29,0x20,0x76,
-    0x61,0x72,0x3c,0x75,0x6e,0x69,0x66,0x6f,0x72,0x6d,0x3e,0x20,0x78,0x5f,0x31,0x38,
-    0x20,0x3a,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x62,0x6f,0x69,0x64,
-    0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,
-    0x76,0x5f,0x70,0x6f,0x73,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x0a,
-    0x40,0x67,0x72,0x6f,0x75,0x70,0x28,0x30,0x29,0x20,0x40,0x62,0x69,0x6e,0x64,0x69,
-    0x6e,0x67,0x28,0x31,0x29,0x20,0x76,0x61,0x72,0x3c,0x75,0x6e,0x69,0x66,0x6f,0x72,
-    0x6d,0x3e,0x20,0x78,0x5f,0x38,0x34,0x20,0x3a,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,
-    0x6d,0x73,0x5f,0x77,0x6f,0x72,0x6c,0x64,0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,
-    0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,
-    0x69,0x6f,0x6e,0x20,0x3a,0x20,0x76,0x65,0x63,0x34,0x66,0x3b,0x0a,0x0a,0x66,0x6e,
-    0x20,0x6d,0x61,0x69,0x6e,0x5f,0x31,0x28,0x29,0x20,0x7b,0x0a,0x20,0x20,0x76,0x61,
-    0x72,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,
-    0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x61,0x6e,0x67,0x6c,0x65,0x20,0x3a,0x20,0x66,
-    0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x6f,0x74,0x78,0x20,0x3a,
-    0x20,0x66,0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x6f,0x74,0x79,
-    0x20,0x3a,0x20,0x66,0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x6f,
-    0x74,0x61,0x74,0x65,0x64,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x20,
-    0x20,0x76,0x61,0x72,0x20,0x77,0x6f,0x72,0x6c,0x64,0x20,0x3a,0x20,0x76,0x65,0x63,
-    0x32,0x66,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x64,0x63,0x78,0x20,0x3a,
-    0x20,0x66,0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x64,0x63,0x79,
-    0x20,0x3a,0x20,0x66,0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x64,
-    0x63,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,
-    0x20,0x78,0x5f,0x31,0x32,0x20,0x3a,0x20,0x76,0x65,0x63,0x33,0x66,0x20,0x3d,0x20,
-    0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x66,0x5f,0x63,0x6f,0x6c,
-    0x6f,0x72,0x20,0x3d,0x20,0x78,0x5f,0x31,0x32,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,
-    0x20,0x78,0x5f,0x32,0x35,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x78,0x5f,
-    0x31,0x38,0x2e,0x76,0x65,0x6c,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,
-    0x78,0x5f,0x32,0x38,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x78,0x5f,0x31,
-    0x38,0x2e,0x76,0x65,0x6c,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x66,0x5f,0x61,0x6e,0x67,
-    0x6c,0x65,0x20,0x3d,0x20,0x61,0x74,0x61,0x6e,0x32,0x28,0x78,0x5f,0x32,0x35,0x2c,
-    0x20,0x78,0x5f,0x32,0x38,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,
-    0x33,0x34,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x20,0x3d,0x20,0x76,0x5f,0x70,
-    0x6f,0x73,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x33,0x37,0x20,0x3a,
-    0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x78,0x5f,0x31,0x38,0x2e,0x73,0x63,0x61,0x6c,
-    0x65,0x3b,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x3d,0x20,0x28,0x78,0x5f,
-    0x33,0x34,0x20,0x2a,0x20,0x78,0x5f,0x33,0x37,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,
-    0x74,0x20,0x78,0x5f,0x34,0x31,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x66,
-    0x5f,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x61,0x6e,0x67,0x6c,0x65,0x20,
-    0x3d,0x20,0x28,0x78,0x5f,0x34,0x31,0x20,0x2d,0x20,0x31,0x2e,0x35,0x37,0x30,0x37,
-    0x39,0x36,0x30,0x31,0x32,0x38,0x37,0x38,0x34,0x31,0x37,0x39,0x36,0x38,0x37,0x35,
-    0x66,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x34,0x36,0x20,0x3a,
-    0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x2e,0x78,0x3b,0x0a,
-    0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x34,0x37,0x20,0x3a,0x20,0x66,0x33,0x32,
-    0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,
-    0x78,0x5f,0x35,0x31,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x6c,0x6f,0x63,
-    0x61,0x6c,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x35,0x32,
-    0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,
-    0x20,0x20,0x72,0x6f,0x74,0x78,0x20,0x3d,0x20,0x28,0x28,0x78,0x5f,0x34,0x36,0x20,
-    0x2a,0x20,0x63,0x6f,0x73,0x28,0x78,0x5f,0x34,0x37,0x29,0x29,0x20,0x2d,0x20,0x28,
-    0x78,0x5f,0x35,0x31,0x20,0x2a,0x20,0x73,0x69,0x6e,0x28,0x78,0x5f,0x35,0x32,0x29,
-    0x29,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x35,0x38,0x20,0x3a,
-    0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x2e,0x78,0x3b,0x0a,
-    0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x35,0x39,0x20,0x3a,0x20,0x66,0x33,0x32,
-    0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,
-    0x78,0x5f,0x36,0x33,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x6c,0x6f,0x63,
-    0x61,0x6c,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x36,0x34,
-    0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,
-    0x20,0x20,0x72,0x6f,0x74,0x79,0x20,0x3d,0x20,0x28,0x28,0x78,0x5f,0x35,0x38,0x20,
-    0x2a,0x20,0x73,0x69,0x6e,0x28,0x78,0x5f,0x35,0x39,0x29,0x29,0x20,0x2b,0x20,0x28,
-    0x78,0x5f,0x36,0x33,0x20,0x2a,0x20,0x63,0x6f,0x73,0x28,0x78,0x5f,0x36,0x34,0x29,
-    0x29,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x36,0x39,0x20,0x3a,
-    0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x72,0x6f,0x74,0x78,0x3b,0x0a,0x20,0x20,0x6c,
-    0x65,0x74,0x20,0x78,0x5f,0x37,0x30,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,
-    0x72,0x6f,0x74,0x79,0x3b,0x0a,0x20,0x20,0x72,0x6f,0x74,0x61,0x74,0x65,0x64,0x20,
-    0x3d,0x20,0x76,0x65,0x63,0x32,0x66,0x28,0x78,0x5f,0x36,0x39,0x2c,0x20,0x78,0x5f,
-    0x37,0x30,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x37,0x36,0x20,
-    0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x20,0x3d,0x20,0x78,0x5f,0x31,0x38,0x2e,0x70,
+    0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
+    0x20,0x3a,0x20,0x76,0x65,0x63,0x33,0x66,0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,
+    0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,
+    0x3a,0x20,0x66,0x33,0x32,0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,0x72,0x69,0x76,
+    0x61,0x74,0x65,0x3e,0x20,0x69,0x5f,0x76,0x65,0x6c,0x20,0x3a,0x20,0x76,0x65,0x63,
+    0x32,0x66,0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,
+    0x3e,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,
+    0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x69,
+    0x5f,0x73,0x63,0x61,0x6c,0x65,0x20,0x3a,0x20,0x66,0x33,0x32,0x3b,0x0a,0x0a,0x76,
+    0x61,0x72,0x3c,0x70,0x72,0x69,0x76,0x61,0x74,0x65,0x3e,0x20,0x69,0x5f,0x70,0x6f,
+    0x73,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x0a,0x40,0x67,0x72,0x6f,
+    0x75,0x70,0x28,0x30,0x29,0x20,0x40,0x62,0x69,0x6e,0x64,0x69,0x6e,0x67,0x28,0x30,
+    0x29,0x20,0x76,0x61,0x72,0x3c,0x75,0x6e,0x69,0x66,0x6f,0x72,0x6d,0x3e,0x20,0x78,
+    0x5f,0x38,0x34,0x20,0x3a,0x20,0x76,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5f,0x77,
+    0x6f,0x72,0x6c,0x64,0x3b,0x0a,0x0a,0x76,0x61,0x72,0x3c,0x70,0x72,0x69,0x76,0x61,
+    0x74,0x65,0x3e,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,
+    0x3a,0x20,0x76,0x65,0x63,0x34,0x66,0x3b,0x0a,0x0a,0x66,0x6e,0x20,0x6d,0x61,0x69,
+    0x6e,0x5f,0x31,0x28,0x29,0x20,0x7b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6c,0x6f,
+    0x63,0x61,0x6c,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x20,0x20,0x76,
+    0x61,0x72,0x20,0x61,0x6e,0x67,0x6c,0x65,0x20,0x3a,0x20,0x66,0x33,0x32,0x3b,0x0a,
+    0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x6f,0x74,0x78,0x20,0x3a,0x20,0x66,0x33,0x32,
+    0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x6f,0x74,0x79,0x20,0x3a,0x20,0x66,
+    0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x6f,0x74,0x61,0x74,0x65,
+    0x64,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,
+    0x20,0x77,0x6f,0x72,0x6c,0x64,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,
+    0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x64,0x63,0x78,0x20,0x3a,0x20,0x66,0x33,0x32,
+    0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x64,0x63,0x79,0x20,0x3a,0x20,0x66,
+    0x33,0x32,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x64,0x63,0x20,0x3a,0x20,
+    0x76,0x65,0x63,0x32,0x66,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x31,
+    0x32,0x20,0x3a,0x20,0x76,0x65,0x63,0x33,0x66,0x20,0x3d,0x20,0x76,0x5f,0x63,0x6f,
+    0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x66,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,
+    0x20,0x78,0x5f,0x31,0x32,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x32,
+    0x35,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x69,0x5f,0x76,0x65,0x6c,0x2e,
+    0x79,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x32,0x38,0x20,0x3a,0x20,
+    0x66,0x33,0x32,0x20,0x3d,0x20,0x69,0x5f,0x76,0x65,0x6c,0x2e,0x78,0x3b,0x0a,0x20,
+    0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x20,0x3d,0x20,0x61,0x74,0x61,0x6e,0x32,
+    0x28,0x78,0x5f,0x32,0x35,0x2c,0x20,0x78,0x5f,0x32,0x38,0x29,0x3b,0x0a,0x20,0x20,
+    0x6c,0x65,0x74,0x20,0x78,0x5f,0x33,0x34,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,
+    0x20,0x3d,0x20,0x76,0x5f,0x70,0x6f,0x73,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,
+    0x78,0x5f,0x33,0x37,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x69,0x5f,0x73,
+    0x63,0x61,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x20,0x3d,0x20,
+    0x28,0x78,0x5f,0x33,0x34,0x20,0x2a,0x20,0x78,0x5f,0x33,0x37,0x29,0x3b,0x0a,0x20,
+    0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x34,0x31,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,
+    0x3d,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x61,0x6e,0x67,
+    0x6c,0x65,0x20,0x3d,0x20,0x28,0x78,0x5f,0x34,0x31,0x20,0x2d,0x20,0x31,0x2e,0x35,
+    0x37,0x30,0x37,0x39,0x36,0x30,0x31,0x32,0x38,0x37,0x38,0x34,0x31,0x37,0x39,0x36,
+    0x38,0x37,0x35,0x66,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x34,
+    0x36,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x2e,
+    0x78,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x34,0x37,0x20,0x3a,0x20,
+    0x66,0x33,0x32,0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x6c,
+    0x65,0x74,0x20,0x78,0x5f,0x35,0x31,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,
+    0x6c,0x6f,0x63,0x61,0x6c,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,
+    0x5f,0x35,0x32,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,
+    0x65,0x3b,0x0a,0x20,0x20,0x72,0x6f,0x74,0x78,0x20,0x3d,0x20,0x28,0x28,0x78,0x5f,
+    0x34,0x36,0x20,0x2a,0x20,0x63,0x6f,0x73,0x28,0x78,0x5f,0x34,0x37,0x29,0x29,0x20,
+    0x2d,0x20,0x28,0x78,0x5f,0x35,0x31,0x20,0x2a,0x20,0x73,0x69,0x6e,0x28,0x78,0x5f,
+    0x35,0x32,0x29,0x29,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x35,
+    0x38,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x6c,0x6f,0x63,0x61,0x6c,0x2e,
+    0x78,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x35,0x39,0x20,0x3a,0x20,
+    0x66,0x33,0x32,0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,0x65,0x3b,0x0a,0x20,0x20,0x6c,
+    0x65,0x74,0x20,0x78,0x5f,0x36,0x33,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,
+    0x6c,0x6f,0x63,0x61,0x6c,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,
+    0x5f,0x36,0x34,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x61,0x6e,0x67,0x6c,
+    0x65,0x3b,0x0a,0x20,0x20,0x72,0x6f,0x74,0x79,0x20,0x3d,0x20,0x28,0x28,0x78,0x5f,
+    0x35,0x38,0x20,0x2a,0x20,0x73,0x69,0x6e,0x28,0x78,0x5f,0x35,0x39,0x29,0x29,0x20,
+    0x2b,0x20,0x28,0x78,0x5f,0x36,0x33,0x20,0x2a,0x20,0x63,0x6f,0x73,0x28,0x78,0x5f,
+    0x36,0x34,0x29,0x29,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x36,
+    0x39,0x20,0x3a,0x20,0x66,0x33,0x32,0x20,0x3d,0x20,0x72,0x6f,0x74,0x78,0x3b,0x0a,
+    0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x37,0x30,0x20,0x3a,0x20,0x66,0x33,0x32,
+    0x20,0x3d,0x20,0x72,0x6f,0x74,0x79,0x3b,0x0a,0x20,0x20,0x72,0x6f,0x74,0x61,0x74,
+    0x65,0x64,0x20,0x3d,0x20,0x76,0x65,0x63,0x32,0x66,0x28,0x78,0x5f,0x36,0x39,0x2c,
+    0x20,0x78,0x5f,0x37,0x30,0x29,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,
+    0x37,0x36,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x20,0x3d,0x20,0x69,0x5f,0x70,
     0x6f,0x73,0x3b,0x0a,0x20,0x20,0x6c,0x65,0x74,0x20,0x78,0x5f,0x37,0x37,0x20,0x3a,
     0x20,0x76,0x65,0x63,0x32,0x66,0x20,0x3d,0x20,0x72,0x6f,0x74,0x61,0x74,0x65,0x64,
     0x3b,0x0a,0x20,0x20,0x77,0x6f,0x72,0x6c,0x64,0x20,0x3d,0x20,0x28,0x78,0x5f,0x37,
@@ -614,17 +610,27 @@ static const uint8_t simple_vs_source_wgsl[2224] = {
     0x66,0x6e,0x20,0x6d,0x61,0x69,0x6e,0x28,0x40,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,
     0x6e,0x28,0x31,0x29,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x5f,0x70,0x61,0x72,
     0x61,0x6d,0x20,0x3a,0x20,0x76,0x65,0x63,0x33,0x66,0x2c,0x20,0x40,0x6c,0x6f,0x63,
-    0x61,0x74,0x69,0x6f,0x6e,0x28,0x30,0x29,0x20,0x76,0x5f,0x70,0x6f,0x73,0x5f,0x70,
-    0x61,0x72,0x61,0x6d,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x29,0x20,0x2d,0x3e,
-    0x20,0x6d,0x61,0x69,0x6e,0x5f,0x6f,0x75,0x74,0x20,0x7b,0x0a,0x20,0x20,0x76,0x5f,
-    0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x5f,
-    0x70,0x61,0x72,0x61,0x6d,0x3b,0x0a,0x20,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x3d,
-    0x20,0x76,0x5f,0x70,0x6f,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x3b,0x0a,0x20,0x20,
-    0x6d,0x61,0x69,0x6e,0x5f,0x31,0x28,0x29,0x3b,0x0a,0x20,0x20,0x72,0x65,0x74,0x75,
-    0x72,0x6e,0x20,0x6d,0x61,0x69,0x6e,0x5f,0x6f,0x75,0x74,0x28,0x66,0x5f,0x63,0x6f,
-    0x6c,0x6f,0x72,0x2c,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x2c,0x20,0x67,0x6c,
-    0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
-
+    0x61,0x74,0x69,0x6f,0x6e,0x28,0x33,0x29,0x20,0x69,0x5f,0x76,0x65,0x6c,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x2c,0x20,0x40,0x6c,
+    0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x28,0x30,0x29,0x20,0x76,0x5f,0x70,0x6f,0x73,
+    0x5f,0x70,0x61,0x72,0x61,0x6d,0x20,0x3a,0x20,0x76,0x65,0x63,0x32,0x66,0x2c,0x20,
+    0x40,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x28,0x34,0x29,0x20,0x69,0x5f,0x73,
+    0x63,0x61,0x6c,0x65,0x5f,0x70,0x61,0x72,0x61,0x6d,0x20,0x3a,0x20,0x66,0x33,0x32,
+    0x2c,0x20,0x40,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x28,0x32,0x29,0x20,0x69,
+    0x5f,0x70,0x6f,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x20,0x3a,0x20,0x76,0x65,0x63,
+    0x32,0x66,0x29,0x20,0x2d,0x3e,0x20,0x6d,0x61,0x69,0x6e,0x5f,0x6f,0x75,0x74,0x20,
+    0x7b,0x0a,0x20,0x20,0x76,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x76,0x5f,
+    0x63,0x6f,0x6c,0x6f,0x72,0x5f,0x70,0x61,0x72,0x61,0x6d,0x3b,0x0a,0x20,0x20,0x69,
+    0x5f,0x76,0x65,0x6c,0x20,0x3d,0x20,0x69,0x5f,0x76,0x65,0x6c,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x3b,0x0a,0x20,0x20,0x76,0x5f,0x70,0x6f,0x73,0x20,0x3d,0x20,0x76,0x5f,
+    0x70,0x6f,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x3b,0x0a,0x20,0x20,0x69,0x5f,0x73,
+    0x63,0x61,0x6c,0x65,0x20,0x3d,0x20,0x69,0x5f,0x73,0x63,0x61,0x6c,0x65,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x3b,0x0a,0x20,0x20,0x69,0x5f,0x70,0x6f,0x73,0x20,0x3d,0x20,
+    0x69,0x5f,0x70,0x6f,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x3b,0x0a,0x20,0x20,0x6d,
+    0x61,0x69,0x6e,0x5f,0x31,0x28,0x29,0x3b,0x0a,0x20,0x20,0x72,0x65,0x74,0x75,0x72,
+    0x6e,0x20,0x6d,0x61,0x69,0x6e,0x5f,0x6f,0x75,0x74,0x28,0x66,0x5f,0x63,0x6f,0x6c,
+    0x6f,0x72,0x2c,0x20,0x66,0x5f,0x61,0x6e,0x67,0x6c,0x65,0x2c,0x20,0x67,0x6c,0x5f,
+    0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     diagnostic(off, derivative_uniformity);
@@ -734,18 +740,15 @@ static inline const sg_shader_desc* simple_shader_desc(sg_backend backend) {
             desc.fragment_func.entry = "main";
             desc.attrs[0].glsl_name = "v_pos";
             desc.attrs[1].glsl_name = "v_color";
+            desc.attrs[2].glsl_name = "i_pos";
+            desc.attrs[3].glsl_name = "i_vel";
+            desc.attrs[4].glsl_name = "i_scale";
             desc.uniform_blocks[0].stage = SG_SHADERSTAGE_VERTEX;
             desc.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
-            desc.uniform_blocks[0].size = 32;
+            desc.uniform_blocks[0].size = 16;
             desc.uniform_blocks[0].glsl_uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
-            desc.uniform_blocks[0].glsl_uniforms[0].array_count = 2;
-            desc.uniform_blocks[0].glsl_uniforms[0].glsl_name = "v_params_boid";
-            desc.uniform_blocks[1].stage = SG_SHADERSTAGE_VERTEX;
-            desc.uniform_blocks[1].layout = SG_UNIFORMLAYOUT_STD140;
-            desc.uniform_blocks[1].size = 16;
-            desc.uniform_blocks[1].glsl_uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
-            desc.uniform_blocks[1].glsl_uniforms[0].array_count = 1;
-            desc.uniform_blocks[1].glsl_uniforms[0].glsl_name = "v_params_world";
+            desc.uniform_blocks[0].glsl_uniforms[0].array_count = 1;
+            desc.uniform_blocks[0].glsl_uniforms[0].glsl_name = "v_params_world";
             desc.label = "simple_shader";
         }
         return &desc;
@@ -765,14 +768,16 @@ static inline const sg_shader_desc* simple_shader_desc(sg_backend backend) {
             desc.attrs[0].hlsl_sem_index = 0;
             desc.attrs[1].hlsl_sem_name = "TEXCOORD";
             desc.attrs[1].hlsl_sem_index = 1;
+            desc.attrs[2].hlsl_sem_name = "TEXCOORD";
+            desc.attrs[2].hlsl_sem_index = 2;
+            desc.attrs[3].hlsl_sem_name = "TEXCOORD";
+            desc.attrs[3].hlsl_sem_index = 3;
+            desc.attrs[4].hlsl_sem_name = "TEXCOORD";
+            desc.attrs[4].hlsl_sem_index = 4;
             desc.uniform_blocks[0].stage = SG_SHADERSTAGE_VERTEX;
             desc.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
-            desc.uniform_blocks[0].size = 32;
+            desc.uniform_blocks[0].size = 16;
             desc.uniform_blocks[0].hlsl_register_b_n = 0;
-            desc.uniform_blocks[1].stage = SG_SHADERSTAGE_VERTEX;
-            desc.uniform_blocks[1].layout = SG_UNIFORMLAYOUT_STD140;
-            desc.uniform_blocks[1].size = 16;
-            desc.uniform_blocks[1].hlsl_register_b_n = 1;
             desc.label = "simple_shader";
         }
         return &desc;
@@ -788,12 +793,8 @@ static inline const sg_shader_desc* simple_shader_desc(sg_backend backend) {
             desc.fragment_func.entry = "main";
             desc.uniform_blocks[0].stage = SG_SHADERSTAGE_VERTEX;
             desc.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
-            desc.uniform_blocks[0].size = 32;
+            desc.uniform_blocks[0].size = 16;
             desc.uniform_blocks[0].wgsl_group0_binding_n = 0;
-            desc.uniform_blocks[1].stage = SG_SHADERSTAGE_VERTEX;
-            desc.uniform_blocks[1].layout = SG_UNIFORMLAYOUT_STD140;
-            desc.uniform_blocks[1].size = 16;
-            desc.uniform_blocks[1].wgsl_group0_binding_n = 1;
             desc.label = "simple_shader";
         }
         return &desc;
@@ -0,0 +1,407 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+// gcc 12 flags the deliberately undefined upper lanes some AVX-512 intrinsics start from; the warning points into
+// the intrinsic headers, so silencing it for them leaves it on for everything else
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// gcc and clang compile functions for instruction sets past the build flags, so one x86 binary carries AVX2 and
+// AVX-512 variants of the hot loops next to the baseline; isa.hpp picks one at runtime
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BOIDS_ISA_VARIANTS 1
+#endif
+
+// everything defined between BEGIN and END is compiled for `features`, a target attribute string
+#define BOIDS_PRAGMA(text) _Pragma(#text)
+#if !defined(BOIDS_ISA_VARIANTS)
+#define BOIDS_TARGET_BEGIN(features)
+#define BOIDS_TARGET_END
+#elif defined(__clang__)
+#define BOIDS_TARGET_BEGIN(features)                                                                                  \
+    BOIDS_PRAGMA(clang attribute push(__attribute__((target(features))), apply_to = function))
+#define BOIDS_TARGET_END BOIDS_PRAGMA(clang attribute pop)
+#else
+#define BOIDS_TARGET_BEGIN(features) BOIDS_PRAGMA(GCC push_options) BOIDS_PRAGMA(GCC target(features))
+#define BOIDS_TARGET_END BOIDS_PRAGMA(GCC pop_options)
+#endif
+
+#define BOIDS_TARGET_AVX2 "avx2"
+#define BOIDS_TARGET_AVX512 "avx2,avx512f"
+
+// masks are lanes with every bit set or cleared, so `keep` is a plain bitwise and and never turns inf into nan
+static const uint32_t LANE_BITS[48] = {
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+typedef struct LanesScalar {
+    float v;
+
+    static constexpr int width = 1;
+
+    static LanesScalar load(const float *ptr) {
+        return LanesScalar{.v = *ptr};
+    }
+
+    void store(float *ptr) const {
+        *ptr = this->v;
+    }
+
+    static LanesScalar broadcast(float value) {
+        return LanesScalar{.v = value};
+    }
+
+    static LanesScalar zeros() {
+        return LanesScalar::broadcast(0);
+    }
+
+    static LanesScalar bits(const uint32_t *ptr) {
+        float value;
+        memcpy(&value, ptr, sizeof(value));
+        return LanesScalar{.v = value};
+    }
+
+    static LanesScalar mask(bool value) {
+        return LanesScalar::bits(value ? &LANE_BITS[0] : &LANE_BITS[16]);
+    }
+
+    LanesScalar add(LanesScalar other) const {
+        return LanesScalar{.v = this->v + other.v};
+    }
+
+    LanesScalar sub(LanesScalar other) const {
+        return LanesScalar{.v = this->v - other.v};
+    }
+
+    LanesScalar mul(LanesScalar other) const {
+        return LanesScalar{.v = this->v * other.v};
+    }
+
+    LanesScalar div(LanesScalar other) const {
+        return LanesScalar{.v = this->v / other.v};
+    }
+
+    LanesScalar sqrt() const {
+        return LanesScalar{.v = std::sqrt(this->v)};
+    }
+
+    LanesScalar less(LanesScalar other) const {
+        return LanesScalar::mask(this->v < other.v);
+    }
+
+    LanesScalar less_equal(LanesScalar other) const {
+        return LanesScalar::mask(this->v <= other.v);
+    }
+
+    LanesScalar greater_equal(LanesScalar other) const {
+        return LanesScalar::mask(this->v >= other.v);
+    }
+
+    LanesScalar both(LanesScalar other) const {
+        return LanesScalar{.v = std::bit_cast<float>(std::bit_cast<uint32_t>(this->v) & std::bit_cast<uint32_t>(other.v))};
+    }
+
+    LanesScalar but_not(LanesScalar other) const {
+        return LanesScalar{.v = std::bit_cast<float>(std::bit_cast<uint32_t>(this->v) & ~std::bit_cast<uint32_t>(other.v))};
+    }
+
+    LanesScalar keep(LanesScalar mask) const {
+        return this->both(mask);
+    }
+
+    // one bit per set lane of a mask, lane 0 lowest
+    uint32_t lane_bits() const {
+        return std::bit_cast<uint32_t>(this->v) != 0;
+    }
+
+    float sum() const {
+        return this->v;
+    }
+} LanesScalar;
+
+#if defined(__SSE2__)
+typedef struct LanesSSE {
+    __m128 v;
+
+    static constexpr int width = 4;
+
+    static LanesSSE load(const float *ptr) {
+        return LanesSSE{.v = _mm_loadu_ps(ptr)};
+    }
+
+    void store(float *ptr) const {
+        _mm_storeu_ps(ptr, this->v);
+    }
+
+    static LanesSSE broadcast(float value) {
+        return LanesSSE{.v = _mm_set1_ps(value)};
+    }
+
+    static LanesSSE zeros() {
+        return LanesSSE{.v = _mm_setzero_ps()};
+    }
+
+    static LanesSSE bits(const uint32_t *ptr) {
+        return LanesSSE{.v = _mm_loadu_ps((const float *)ptr)};
+    }
+
+    LanesSSE add(LanesSSE other) const {
+        return LanesSSE{.v = _mm_add_ps(this->v, other.v)};
+    }
+
+    LanesSSE sub(LanesSSE other) const {
+        return LanesSSE{.v = _mm_sub_ps(this->v, other.v)};
+    }
+
+    LanesSSE mul(LanesSSE other) const {
+        return LanesSSE{.v = _mm_mul_ps(this->v, other.v)};
+    }
+
+    LanesSSE div(LanesSSE other) const {
+        return LanesSSE{.v = _mm_div_ps(this->v, other.v)};
+    }
+
+    LanesSSE sqrt() const {
+        return LanesSSE{.v = _mm_sqrt_ps(this->v)};
+    }
+
+    LanesSSE less(LanesSSE other) const {
+        return LanesSSE{.v = _mm_cmplt_ps(this->v, other.v)};
+    }
+
+    LanesSSE less_equal(LanesSSE other) const {
+        return LanesSSE{.v = _mm_cmple_ps(this->v, other.v)};
+    }
+
+    LanesSSE greater_equal(LanesSSE other) const {
+        return LanesSSE{.v = _mm_cmpge_ps(this->v, other.v)};
+    }
+
+    LanesSSE both(LanesSSE other) const {
+        return LanesSSE{.v = _mm_and_ps(this->v, other.v)};
+    }
+
+    LanesSSE but_not(LanesSSE other) const {
+        return LanesSSE{.v = _mm_andnot_ps(other.v, this->v)};
+    }
+
+    LanesSSE keep(LanesSSE mask) const {
+        return this->both(mask);
+    }
+
+    uint32_t lane_bits() const {
+        return _mm_movemask_ps(this->v);
+    }
+
+    float sum() const {
+        __m128 high = _mm_movehl_ps(this->v, this->v);
+        __m128 pair = _mm_add_ps(this->v, high);
+        __m128 odd = _mm_shuffle_ps(pair, pair, 0x55);
+        return _mm_cvtss_f32(_mm_add_ss(pair, odd));
+    }
+} LanesSSE;
+#endif
+
+#if defined(__AVX2__) || defined(BOIDS_ISA_VARIANTS)
+BOIDS_TARGET_BEGIN(BOIDS_TARGET_AVX2)
+typedef struct LanesAVX2 {
+    __m256 v;
+
+    static constexpr int width = 8;
+
+    static LanesAVX2 load(const float *ptr) {
+        return LanesAVX2{.v = _mm256_loadu_ps(ptr)};
+    }
+
+    void store(float *ptr) const {
+        _mm256_storeu_ps(ptr, this->v);
+    }
+
+    static LanesAVX2 broadcast(float value) {
+        return LanesAVX2{.v = _mm256_set1_ps(value)};
+    }
+
+    static LanesAVX2 zeros() {
+        return LanesAVX2{.v = _mm256_setzero_ps()};
+    }
+
+    static LanesAVX2 bits(const uint32_t *ptr) {
+        return LanesAVX2{.v = _mm256_loadu_ps((const float *)ptr)};
+    }
+
+    LanesAVX2 add(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_add_ps(this->v, other.v)};
+    }
+
+    LanesAVX2 sub(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_sub_ps(this->v, other.v)};
+    }
+
+    LanesAVX2 mul(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_mul_ps(this->v, other.v)};
+    }
+
+    LanesAVX2 div(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_div_ps(this->v, other.v)};
+    }
+
+    LanesAVX2 sqrt() const {
+        return LanesAVX2{.v = _mm256_sqrt_ps(this->v)};
+    }
+
+    LanesAVX2 less(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_cmp_ps(this->v, other.v, _CMP_LT_OQ)};
+    }
+
+    LanesAVX2 less_equal(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_cmp_ps(this->v, other.v, _CMP_LE_OQ)};
+    }
+
+    LanesAVX2 greater_equal(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_cmp_ps(this->v, other.v, _CMP_GE_OQ)};
+    }
+
+    LanesAVX2 both(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_and_ps(this->v, other.v)};
+    }
+
+    LanesAVX2 but_not(LanesAVX2 other) const {
+        return LanesAVX2{.v = _mm256_andnot_ps(other.v, this->v)};
+    }
+
+    LanesAVX2 keep(LanesAVX2 mask) const {
+        return this->both(mask);
+    }
+
+    uint32_t lane_bits() const {
+        return _mm256_movemask_ps(this->v);
+    }
+
+    float sum() const {
+        __m128 low = _mm256_castps256_ps128(this->v);
+        __m128 high = _mm256_extractf128_ps(this->v, 1);
+        return LanesSSE{.v = _mm_add_ps(low, high)}.sum();
+    }
+} LanesAVX2;
+BOIDS_TARGET_END
+#endif
+
+#if defined(BOIDS_ISA_VARIANTS)
+BOIDS_TARGET_BEGIN(BOIDS_TARGET_AVX512)
+// AVX-512F compares into mask registers and has no float and/andnot, so masks are widened back to full lanes and
+// combined as integers to keep the all-bits convention of the narrower lanes
+typedef struct LanesAVX512 {
+    __m512 v;
+
+    static constexpr int width = 16;
+
+    static LanesAVX512 load(const float *ptr) {
+        return LanesAVX512{.v = _mm512_loadu_ps(ptr)};
+    }
+
+    void store(float *ptr) const {
+        _mm512_storeu_ps(ptr, this->v);
+    }
+
+    static LanesAVX512 broadcast(float value) {
+        return LanesAVX512{.v = _mm512_set1_ps(value)};
+    }
+
+    static LanesAVX512 zeros() {
+        return LanesAVX512{.v = _mm512_setzero_ps()};
+    }
+
+    static LanesAVX512 bits(const uint32_t *ptr) {
+        return LanesAVX512{.v = _mm512_loadu_ps((const float *)ptr)};
+    }
+
+    static LanesAVX512 mask(__mmask16 mask) {
+        return LanesAVX512{.v = _mm512_castsi512_ps(_mm512_maskz_set1_epi32(mask, -1))};
+    }
+
+    LanesAVX512 add(LanesAVX512 other) const {
+        return LanesAVX512{.v = _mm512_add_ps(this->v, other.v)};
+    }
+
+    LanesAVX512 sub(LanesAVX512 other) const {
+        return LanesAVX512{.v = _mm512_sub_ps(this->v, other.v)};
+    }
+
+    LanesAVX512 mul(LanesAVX512 other) const {
+        return LanesAVX512{.v = _mm512_mul_ps(this->v, other.v)};
+    }
+
+    LanesAVX512 div(LanesAVX512 other) const {
+        return LanesAVX512{.v = _mm512_div_ps(this->v, other.v)};
+    }
+
+    LanesAVX512 sqrt() const {
+        return LanesAVX512{.v = _mm512_sqrt_ps(this->v)};
+    }
+
+    LanesAVX512 less(LanesAVX512 other) const {
+        return LanesAVX512::mask(_mm512_cmp_ps_mask(this->v, other.v, _CMP_LT_OQ));
+    }
+
+    LanesAVX512 less_equal(LanesAVX512 other) const {
+        return LanesAVX512::mask(_mm512_cmp_ps_mask(this->v, other.v, _CMP_LE_OQ));
+    }
+
+    LanesAVX512 greater_equal(LanesAVX512 other) const {
+        return LanesAVX512::mask(_mm512_cmp_ps_mask(this->v, other.v, _CMP_GE_OQ));
+    }
+
+    LanesAVX512 both(LanesAVX512 other) const {
+        __m512i bits = _mm512_and_si512(_mm512_castps_si512(this->v), _mm512_castps_si512(other.v));
+        return LanesAVX512{.v = _mm512_castsi512_ps(bits)};
+    }
+
+    LanesAVX512 but_not(LanesAVX512 other) const {
+        __m512i bits = _mm512_andnot_si512(_mm512_castps_si512(other.v), _mm512_castps_si512(this->v));
+        return LanesAVX512{.v = _mm512_castsi512_ps(bits)};
+    }
+
+    LanesAVX512 keep(LanesAVX512 mask) const {
+        return this->both(mask);
+    }
+
+    uint32_t lane_bits() const {
+        __m512i bits = _mm512_castps_si512(this->v);
+        return _mm512_test_epi32_mask(bits, bits);
+    }
+
+    float sum() const {
+        __m256 low = _mm512_castps512_ps256(this->v);
+        __m256 high = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(this->v), 1));
+        return LanesAVX2{.v = _mm256_add_ps(low, high)}.sum();
+    }
+} LanesAVX512;
+BOIDS_TARGET_END
+#endif
+
+// the widest lanes the build flags allow, which the baseline variant runs with
+#if defined(__AVX2__)
+typedef LanesAVX2 LanesNative;
+#elif defined(__SSE2__)
+typedef LanesSSE LanesNative;
+#else
+typedef LanesScalar LanesNative;
+#endif
+
+#endif
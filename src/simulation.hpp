@@ -0,0 +1,255 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "boids.hpp"
+#include "checkpoint.hpp"
+#include "vector.hpp"
+
+#define TRIPLE_INDEX 3
+#define TRIPLE_FRESH 4
+#define MAX_CATCHUP_STEPS 4
+
+// single producer, single consumer; the writer and reader each own a slot and trade through `middle` without locking
+template <typename T> struct TripleBuffer {
+    T slots[3];
+    std::atomic<int> middle = 1;
+    int back = 0;
+    int front = 2;
+
+    T *write_slot() {
+        return &this->slots[this->back];
+    }
+
+    void publish() {
+        this->back = this->middle.exchange(this->back | TRIPLE_FRESH, std::memory_order_acq_rel) & TRIPLE_INDEX;
+    }
+
+    // the newest published slot, or the one returned last time when nothing new has arrived
+    const T *read() {
+        if (this->middle.load(std::memory_order_relaxed) & TRIPLE_FRESH) {
+            this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & TRIPLE_INDEX;
+        }
+        return &this->slots[this->front];
+    }
+};
+
+// what the renderer needs from one completed step, plus the positions one step earlier to interpolate from
+typedef struct Snapshot {
+    std::vector<Vec2> previous;
+    std::vector<Vec2> positions;
+    std::vector<Vec2> velocities;
+    BoundingBox bounds;
+    float boid_scale;
+    int vertices;
+    bool wrap;
+    long long step;
+    std::chrono::steady_clock::time_point stepped_at;
+
+    void capture(const World *world) {
+        int count = world->data.boids.size();
+        this->positions.resize(count);
+        this->velocities.resize(count);
+        for (int i = 0; i < count; i += 1) {
+            this->positions[i] = world->data.boids[i].position;
+            this->velocities[i] = world->data.boids[i].velocity;
+        }
+        this->bounds = world->bounds;
+        this->boid_scale = world->data.params.boid_scale;
+        this->vertices = world->data.params.vertices;
+        this->wrap = world->data.engine.boundary == BOUNDARY_TORUS;
+    }
+
+    // boids spawned on the last step have no earlier position and are drawn where they are; on a torus a boid that
+    // wrapped keeps going past the edge it left until the step lands
+    Vec2 position(int index, float alpha) const {
+        if (index >= (int)this->previous.size()) {
+            return this->positions[index];
+        }
+        Vec2 from = this->previous[index];
+        Vec2 step = this->wrap ? this->bounds.box_wrapped_postion(&from, &this->positions[index])
+                               : this->positions[index].sub(from);
+        return from.add(step.mul(alpha));
+    }
+} Snapshot;
+
+// steps `world` at a fixed wall clock rate on its own thread, so a slow step never holds up a frame
+typedef struct SimulationThread {
+    World world;
+    float step_time;
+    float steps_per_second;
+    TripleBuffer<Snapshot> snapshots;
+    std::vector<Vec2> before_step;
+    std::vector<Vec2> reordered;
+    std::atomic<bool> running;
+    std::thread thread;
+
+    // params and bounds written by the render thread, picked up before the next step. The render thread also reads
+    // the world's params and bounds under it, so the sim thread only writes those under it too
+    std::mutex lock;
+    BoidParams pending_params;
+    BoundingBox pending_bounds;
+    bool pending;
+    const char *checkpoint_path;
+    bool pending_save;
+    bool pending_restore;
+
+    ~SimulationThread() {
+        this->stop();
+    }
+
+    void start() {
+        Snapshot *snapshot = this->snapshots.write_slot();
+        snapshot->capture(&this->world);
+        snapshot->previous = snapshot->positions;
+        snapshot->step = 0;
+        snapshot->stepped_at = std::chrono::steady_clock::now();
+        this->snapshots.publish();
+
+        this->running = true;
+        this->thread = std::thread(&SimulationThread::run, this);
+    }
+
+    void stop() {
+        this->running = false;
+        if (this->thread.joinable()) {
+            this->thread.join();
+        }
+    }
+
+    void set_params(const BoidParams *params) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (!this->pending) {
+            this->pending_bounds = this->world.bounds;
+        }
+        this->pending_params = *params;
+        this->pending = true;
+    }
+
+    void set_bounds(const BoundingBox *bounds) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (!this->pending) {
+            this->pending_params = this->world.data.params;
+        }
+        this->pending_bounds = *bounds;
+        this->pending = true;
+    }
+
+    // checkpoints are written and read between steps; the caller reads the checkpoint's params for its own copy
+    void request_save(const char *path) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->checkpoint_path = path;
+        this->pending_save = true;
+    }
+
+    void request_restore(const char *path) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->checkpoint_path = path;
+        this->pending_restore = true;
+    }
+
+    void take_pending() {
+        bool save = false;
+        bool restore = false;
+        const char *path = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if (this->pending) {
+                this->world.data.params = this->pending_params;
+                this->world.bounds = this->pending_bounds;
+                this->pending = false;
+            }
+            save = this->pending_save;
+            restore = this->pending_restore;
+            path = this->checkpoint_path;
+            this->pending_save = false;
+            this->pending_restore = false;
+        }
+
+        if (save) {
+            int count = this->world.data.boids.size();
+            printf(save_checkpoint(path, &this->world) ? "saved %d boids to %s\n" : "cannot save %d boids to %s\n",
+                   count, path);
+        }
+        // the window decides the bounds, not the checkpoint; the file is mapped and checked before taking the lock,
+        // which is held only while the restore writes the world
+        if (restore) {
+            CheckpointFile checkpoint = CheckpointFile::map(path);
+            if (checkpoint.valid()) {
+                {
+                    std::lock_guard<std::mutex> guard(this->lock);
+                    BoundingBox bounds = this->world.bounds;
+                    checkpoint.restore(&this->world);
+                    this->world.bounds = bounds;
+                }
+                printf("restored %d boids from %s\n", checkpoint.boid_count(), path);
+            } else {
+                printf("cannot restore %s: %s\n", path, checkpoint.error);
+            }
+            checkpoint.unmap();
+        }
+    }
+
+    // the accumulator carries leftover wall time between wakeups; it is capped so an overloaded sim slows
+    // down instead of falling further and further behind
+    void run() {
+        std::chrono::duration<double> period(1.0 / this->steps_per_second);
+        std::chrono::duration<double> accumulator(0);
+        std::chrono::duration<double> catchup = period * MAX_CATCHUP_STEPS;
+        auto previous = std::chrono::steady_clock::now();
+        long long step = 0;
+
+        while (this->running) {
+            auto now = std::chrono::steady_clock::now();
+            accumulator = std::min<std::chrono::duration<double>>(accumulator + (now - previous), catchup);
+            previous = now;
+
+            if (accumulator < period) {
+                std::this_thread::sleep_for(period - accumulator);
+                continue;
+            }
+
+            this->take_pending();
+            while (accumulator >= period) {
+                PROFILE_SCOPE("SimulationThread::step");
+                this->before_step.resize(this->world.data.boids.size());
+                for (int i = 0; i < (int)this->before_step.size(); i += 1) {
+                    this->before_step[i] = this->world.data.boids[i].position;
+                }
+                this->world.update(this->step_time);
+                // a reorder inside the step permuted the boids, the earlier positions have to follow them
+                if (this->world.data.reordered) {
+                    const std::vector<int> &order = this->world.data.order;
+                    this->reordered.resize(order.size());
+                    for (int k = 0; k < (int)order.size(); k += 1) {
+                        this->reordered[k] = this->before_step[order[k]];
+                    }
+                    this->before_step.swap(this->reordered);
+                }
+                accumulator -= period;
+                step += 1;
+            }
+
+            Snapshot *snapshot = this->snapshots.write_slot();
+            snapshot->capture(&this->world);
+            snapshot->previous.assign(this->before_step.begin(), this->before_step.end());
+            snapshot->step = step;
+            snapshot->stepped_at = std::chrono::steady_clock::now();
+            this->snapshots.publish();
+        }
+    }
+
+    // renders trail the sim by one step, blending from the previous step towards the newest as wall time passes
+    float alpha(const Snapshot *snapshot) const {
+        std::chrono::duration<double> since = std::chrono::steady_clock::now() - snapshot->stepped_at;
+        return std::clamp<float>(since.count() * this->steps_per_second, 0, 1);
+    }
+} SimulationThread;
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "threads.hpp"
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// spreads the low 16 bits of v so a zero sits between every pair of bits
+static inline uint32_t morton_spread(uint32_t v) {
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// z-order position of a cell, neighbors on the curve are mostly neighbors on the grid
+static inline uint32_t morton_code(int x, int y) {
+    return morton_spread(x) | (morton_spread(y) << 1);
+}
+
+// stable lsd radix sort of (key, value) pairs, each pass splits the keys into one contiguous chunk per worker
+typedef struct RadixSort {
+    std::vector<uint32_t> keys;
+    std::vector<int> values;
+    std::vector<uint32_t> keys_scratch;
+    std::vector<int> values_scratch;
+    std::vector<int> offsets;
+
+    void resize(int count) {
+        this->keys.resize(count);
+        this->values.resize(count);
+        this->keys_scratch.resize(count);
+        this->values_scratch.resize(count);
+    }
+
+    void sort(ThreadPool *pool) {
+        int count = this->keys.size();
+        int workers = pool->size();
+        this->offsets.resize(workers * RADIX_BUCKETS);
+
+        for (int shift = 0; shift < 32; shift += RADIX_BITS) {
+            std::fill(this->offsets.begin(), this->offsets.end(), 0);
+            auto histogram = [&](int worker) {
+                int *counts = &this->offsets[worker * RADIX_BUCKETS];
+                int begin = (long long)count * worker / workers;
+                int end = (long long)count * (worker + 1) / workers;
+                for (int i = begin; i < end; i += 1) {
+                    counts[(this->keys[i] >> shift) & (RADIX_BUCKETS - 1)] += 1;
+                }
+            };
+            pool->run(histogram);
+
+            // bucket-major, worker-minor prefix: worker w writes its share of a bucket after workers 0..w-1
+            int running = 0;
+            bool single = false;
+            for (int bucket = 0; bucket < RADIX_BUCKETS; bucket += 1) {
+                int before = running;
+                for (int worker = 0; worker < workers; worker += 1) {
+                    int &offset = this->offsets[worker * RADIX_BUCKETS + bucket];
+                    int size = offset;
+                    offset = running;
+                    running += size;
+                }
+                single = single || running - before == count;
+            }
+            // every key has the same digit here, the pass would copy the arrays unchanged
+            if (single) {
+                continue;
+            }
+
+            auto scatter = [&](int worker) {
+                int *next = &this->offsets[worker * RADIX_BUCKETS];
+                int begin = (long long)count * worker / workers;
+                int end = (long long)count * (worker + 1) / workers;
+                for (int i = begin; i < end; i += 1) {
+                    int slot = next[(this->keys[i] >> shift) & (RADIX_BUCKETS - 1)];
+                    next[(this->keys[i] >> shift) & (RADIX_BUCKETS - 1)] += 1;
+                    this->keys_scratch[slot] = this->keys[i];
+                    this->values_scratch[slot] = this->values[i];
+                }
+            };
+            pool->run(scatter);
+            this->keys.swap(this->keys_scratch);
+            this->values.swap(this->values_scratch);
+        }
+    }
+} RadixSort;
+
+#endif
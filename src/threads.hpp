@@ -0,0 +1,117 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef void (*PoolTask)(void *context, int worker);
+
+// persistent workers that all run the same task; the calling thread joins in as worker 0
+typedef struct ThreadPool {
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable start;
+    std::condition_variable finish;
+    PoolTask task;
+    void *context;
+    int generation;
+    int pending;
+    bool stopping;
+
+    ~ThreadPool() {
+        this->stop();
+    }
+
+    int size() const {
+        return this->threads.size() + 1;
+    }
+
+    void resize(int count) {
+        if (count < 1) {
+            count = 1;
+        }
+        if (count == this->size()) {
+            return;
+        }
+
+        this->stop();
+        this->stopping = false;
+        for (int worker = 1; worker < count; worker += 1) {
+            this->threads.push_back(std::thread(&ThreadPool::work, this, worker, this->generation));
+        }
+    }
+
+    // runs `function(worker)` once on every worker and returns when all of them are done
+    template <typename Function> void run(Function &function) {
+        if (this->threads.empty()) {
+            function(0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->task = [](void *context, int worker) { (*(Function *)context)(worker); };
+            this->context = &function;
+            this->pending = this->threads.size();
+            this->generation += 1;
+        }
+        this->start.notify_all();
+
+        function(0);
+
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->finish.wait(guard, [this]() { return this->pending == 0; });
+    }
+
+    // splits [0, count) into one contiguous chunk per worker
+    template <typename Function> void parallel_for(int count, Function function) {
+        int workers = this->size();
+        auto chunk = [&](int worker) {
+            int begin = (long long)count * worker / workers;
+            int end = (long long)count * (worker + 1) / workers;
+            function(begin, end);
+        };
+        this->run(chunk);
+    }
+
+    void work(int worker, int seen) {
+        while (true) {
+            PoolTask task;
+            void *context;
+            {
+                std::unique_lock<std::mutex> guard(this->lock);
+                this->start.wait(guard, [&]() { return this->stopping || this->generation != seen; });
+                if (this->stopping) {
+                    return;
+                }
+                seen = this->generation;
+                task = this->task;
+                context = this->context;
+            }
+
+            task(context, worker);
+
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->pending -= 1;
+            if (this->pending == 0) {
+                this->finish.notify_one();
+            }
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->stopping = true;
+        }
+        this->start.notify_all();
+        for (std::thread &thread : this->threads) {
+            thread.join();
+        }
+        this->threads.clear();
+    }
+} ThreadPool;
+
+#endif
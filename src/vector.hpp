@@ -59,6 +59,10 @@ typedef struct Vec2 {
         return sqrt(this->inner_product(*this));
     }
 
+    float length_squared() const {
+        return this->x * this->x + this->y * this->y;
+    }
+
     Vec2 normalized() {
         return this->div(this->length());
     }